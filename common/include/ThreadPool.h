@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A pool of worker threads that run jobs in parallel with the calling thread
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Start the worker threads
+     * @param threadCount Number of threads that run the jobs, including the calling thread
+     */
+    explicit ThreadPool(std::size_t threadCount) noexcept;
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+private:
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _doneCondition;
+
+    const std::function<void(std::size_t)>* _job { nullptr };
+    std::size_t _jobCount { 0 };
+    std::atomic<std::size_t> _nextJob { 0 };
+    /**
+     * @brief Number of workers that have not finished the current jobs
+     */
+    std::size_t _workingThreads { 0 };
+    /**
+     * @brief Incremented each time jobs are given, to wake up the workers
+     */
+    std::size_t _generation { 0 };
+    bool _stop { false };
+
+    void workerLoop() noexcept;
+    /**
+     * @brief Run the jobs that are not taken yet until there are none left
+     */
+    void runJobs(const std::function<void(std::size_t)>& job) noexcept;
+
+public:
+    /**
+     * @brief Run a job for each index on all the threads and wait until they are all done.
+     * The jobs are taken in order by the first free thread, they must not call ParallelFor.
+     * @param count Number of jobs
+     * @param job The job to run with the index of the job
+     */
+    void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& job) noexcept;
+
+    /**
+     * @brief Get the number of threads that run the jobs, including the calling thread
+     */
+    [[nodiscard]] std::size_t GetThreadCount() const noexcept;
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+ThreadPool::ThreadPool(std::size_t threadCount) noexcept
+{
+    for (std::size_t i = 1; i < threadCount; i++)
+    {
+        _threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::scoped_lock lock(_mutex);
+        _stop = true;
+    }
+
+    _workCondition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::workerLoop() noexcept
+{
+    std::size_t generation = 0;
+
+    while (true)
+    {
+        std::unique_lock lock(_mutex);
+
+        _workCondition.wait(lock, [this, generation] { return _stop || _generation != generation; });
+
+        if (_stop) return;
+
+        generation = _generation;
+        const auto& job = *_job;
+
+        lock.unlock();
+        runJobs(job);
+        lock.lock();
+
+        if (--_workingThreads == 0)
+        {
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runJobs(const std::function<void(std::size_t)>& job) noexcept
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+
+    for (auto i = _nextJob.fetch_add(1); i < _jobCount; i = _nextJob.fetch_add(1))
+    {
+        job(i);
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& job) noexcept
+{
+    if (count == 0) return;
+
+    if (_threads.empty() || count == 1)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            job(i);
+        }
+
+        return;
+    }
+
+    {
+        std::scoped_lock lock(_mutex);
+
+        _job = &job;
+        _jobCount = count;
+        _nextJob = 0;
+        _workingThreads = _threads.size();
+        _generation++;
+    }
+
+    _workCondition.notify_all();
+
+    runJobs(job);
+
+    std::unique_lock lock(_mutex);
+
+    _doneCondition.wait(lock, [this] { return _workingThreads == 0; });
+}
+
+std::size_t ThreadPool::GetThreadCount() const noexcept
+{
+    return _threads.size() + 1;
+}
\ No newline at end of file
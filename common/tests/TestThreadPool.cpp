@@ -0,0 +1,49 @@
+#include "ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+TEST(ThreadPool, ThreadCount)
+{
+	ThreadPool threadPool(4);
+
+	EXPECT_EQ(threadPool.GetThreadCount(), 4);
+
+	ThreadPool singleThreadPool(1);
+
+	EXPECT_EQ(singleThreadPool.GetThreadCount(), 1);
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+	ThreadPool threadPool(4);
+	std::vector<int> results(1'000, 0);
+
+	// Run it several times to reuse the workers
+	for (int run = 1; run <= 10; run++)
+	{
+		threadPool.ParallelFor(results.size(), [&results](std::size_t i) {
+			results[i]++;
+		});
+
+		for (const auto result : results)
+		{
+			EXPECT_EQ(result, run);
+		}
+	}
+}
+
+TEST(ThreadPool, Empty)
+{
+	ThreadPool threadPool(4);
+	std::atomic<std::size_t> count = 0;
+
+	threadPool.ParallelFor(0, [&count](std::size_t) { count++; });
+
+	EXPECT_EQ(count, 0);
+
+	threadPool.ParallelFor(1, [&count](std::size_t) { count++; });
+
+	EXPECT_EQ(count, 1);
+}
\ No newline at end of file
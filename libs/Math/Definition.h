@@ -8,6 +8,7 @@
 #define NOALIAS __declspec(noalias)
 #define FORCE_INLINE __forceinline
 #else
-#define NOALIAS __attribute__((const))
+// The functions marked NOALIAS read their arguments and *this, so they are pure and not const
+#define NOALIAS __attribute__((pure))
 #define FORCE_INLINE __attribute__((always_inline))
 #endif
\ No newline at end of file
@@ -1,7 +1,14 @@
 #pragma once
 
 #include "Vec2.h"
-
+#include "NVec2.h"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace Math
@@ -142,35 +149,110 @@ namespace Math
     using RectangleF = Rectangle<float>;
     using RectangleI = Rectangle<int>;
 
+    /**
+     * @brief A convex polygon. Up to InlineCapacity vertices are stored in the polygon itself, only bigger polygons allocate.
+     * The normals of the edges are computed once when the vertices are set.
+     */
     template <typename T>
     class Polygon
     {
     public:
+        Polygon() noexcept = default;
         /**
          * @brief Construct a new Polygon object
          * @param vertices the vertices of the polygon
          */
-        constexpr explicit Polygon(std::vector<Vec2<T>> vertices) noexcept : _vertices(vertices) {}
+        explicit Polygon(std::span<const Vec2<T>> vertices) noexcept
+        {
+            SetVertices(vertices);
+        }
+        explicit Polygon(std::initializer_list<Vec2<T>> vertices) noexcept : Polygon(std::span<const Vec2<T>>(vertices.begin(), vertices.size())) {}
+
+        static constexpr std::size_t InlineCapacity = 8;
 
     private:
-        std::vector<Vec2<T>> _vertices;
+        std::array<Vec2<T>, InlineCapacity> _inlineVertices {};
+        std::array<Vec2<T>, InlineCapacity> _inlineNormals {};
+        /**
+         * @brief The vertices and normals of a polygon with more vertices than the inline capacity
+         */
+        std::vector<Vec2<T>> _heapVertices;
+        std::vector<Vec2<T>> _heapNormals;
+        std::size_t _count {0};
+
+        [[nodiscard]] std::span<Vec2<T>> vertices() noexcept
+        {
+            return {_count <= InlineCapacity ? _inlineVertices.data() : _heapVertices.data(), _count};
+        }
+
+        [[nodiscard]] std::span<Vec2<T>> normals() noexcept
+        {
+            return {_count <= InlineCapacity ? _inlineNormals.data() : _heapNormals.data(), _count};
+        }
 
     public:
-        [[nodiscard]] constexpr std::vector<Vec2<T>> Vertices() const noexcept { return _vertices; }
-        [[nodiscard]] constexpr int VerticesCount() const noexcept { return _vertices.size(); }
+        [[nodiscard]] std::span<const Vec2<T>> Vertices() const noexcept
+        {
+            return {_count <= InlineCapacity ? _inlineVertices.data() : _heapVertices.data(), _count};
+        }
+
+        /**
+         * @brief Get the normals of the edges, the normal at an index is the one of the edge that ends at the vertex of this index.
+         * The normals are normalized for the floating point types and zero for the edges without length
+         * @return the normals of the edges
+         */
+        [[nodiscard]] std::span<const Vec2<T>> Normals() const noexcept
+        {
+            return {_count <= InlineCapacity ? _inlineNormals.data() : _heapNormals.data(), _count};
+        }
+
+        [[nodiscard]] constexpr int VerticesCount() const noexcept { return static_cast<int>(_count); }
 
-        void SetVertices(std::vector<Vec2<T>> vertices) noexcept { _vertices = vertices; }
+        void SetVertices(std::span<const Vec2<T>> vertices) noexcept
+        {
+            _count = vertices.size();
+
+            if (_count > InlineCapacity)
+            {
+                _heapVertices.assign(vertices.begin(), vertices.end());
+                _heapNormals.resize(_count);
+            }
+            else
+            {
+                _heapVertices.clear();
+                _heapNormals.clear();
+                std::copy(vertices.begin(), vertices.end(), _inlineVertices.begin());
+            }
+
+            const auto ownVertices = Vertices();
+            const auto ownNormals = normals();
+
+            for (std::size_t i = 0, j = _count - 1; i < _count; j = i++)
+            {
+                const auto edge = ownVertices[i] - ownVertices[j];
+                auto normal = Vec2<T>(-edge.Y, edge.X);
+
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    const auto length = normal.Length();
+
+                    normal = length == 0 ? Vec2<T>::Zero() : normal / length;
+                }
+
+                ownNormals[i] = normal;
+            }
+        }
 
         [[nodiscard]] constexpr Vec2<T> Center() const noexcept
         {
             Vec2<T> center = Vec2<T>::Zero();
 
-            for (const auto& vertex : _vertices)
+            for (const auto& vertex : Vertices())
             {
                 center += vertex;
             }
 
-            return center / _vertices.size();
+            return center / _count;
         }
 
         [[nodiscard]] constexpr Vec2<T> Size() const noexcept
@@ -178,7 +260,7 @@ namespace Math
             Vec2<T> minBound = Vec2<T>::Zero();
             Vec2<T> maxBound = Vec2<T>::Zero();
 
-            for (const auto& vertex : _vertices)
+            for (const auto& vertex : Vertices())
             {
                 minBound.X = Math::Min(minBound.X, vertex.X);
                 minBound.Y = Math::Min(minBound.Y, vertex.Y);
@@ -189,23 +271,102 @@ namespace Math
 
             return maxBound - minBound;
         }
-		
-		[[nodiscard]] constexpr Polygon<T> operator+(const Vec2<T>& vec) const noexcept
+
+        /**
+         * @brief Check if the polygon contains a point, by counting the edges crossed by a ray going to the right of the point
+         * @param point the point to check
+         * @return true if the point is inside the polygon, false otherwise
+         */
+        [[nodiscard]] bool Contains(Vec2<T> point) const
+        {
+            const auto vertices = Vertices();
+            bool inside = false;
+
+            for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+            {
+                const auto& a = vertices[i];
+                const auto& b = vertices[j];
+
+                if ((a.Y > point.Y) == (b.Y > point.Y)) continue;
+
+                if (point.X < a.X + (point.Y - a.Y) * (b.X - a.X) / (b.Y - a.Y))
+                {
+                    inside = !inside;
+                }
+            }
+
+            return inside;
+        }
+
+        /**
+         * @brief Set the vertices to the ones of a polygon moved by an offset, 2 vertices at a time with SSE.
+         * The normals of the edges do not change with the move, they are only copied when the polygon has another number of vertices
+         * @param polygon the polygon to move, with the same edges as this one
+         * @param offset the move
+         */
+        void SetTranslated(const Polygon<T>& polygon, Vec2<T> offset) noexcept
+        {
+            if (polygon._count != _count)
+            {
+                *this = polygon;
+            }
+
+            const auto source = polygon.Vertices();
+            const auto target = vertices();
+            std::size_t i = 0;
+
+#ifdef __SSE__
+            if constexpr (std::is_same_v<T, float>)
+            {
+                static_assert(sizeof(Vec2<float>) == 2 * sizeof(float), "The vertices are read as pairs of floats");
+
+                const auto offsets = _mm_setr_ps(offset.X, offset.Y, offset.X, offset.Y);
+
+                for (; i + 2 <= _count; i += 2)
+                {
+                    _mm_storeu_ps(&target[i].X, _mm_add_ps(_mm_loadu_ps(&source[i].X), offsets));
+                }
+            }
+#endif
+
+            for (; i < _count; i++)
+            {
+                target[i] = source[i] + offset;
+            }
+        }
+
+        /**
+         * @brief Move the polygon, the normals of its edges do not change
+         */
+		[[nodiscard]] Polygon<T> operator+(const Vec2<T>& vec) const noexcept
 	    {
-		    std::vector<Vec2<T>> vertices = _vertices;
+		    Polygon<T> polygon = *this;
 
-		    for (auto& vertex : vertices)
-		    {
-			    vertex += vec;
-		    }
+		    polygon.SetTranslated(*this, vec);
 
-		    return Polygon<T>(vertices);
+		    return polygon;
 	    }
     };
 
     using PolygonF = Polygon<float>;
     using PolygonI = Polygon<int>;
 
+    /**
+     * @brief Get the corners of a rectangle as a polygon
+     * @param rectangle the rectangle
+     * @return the polygon of the corners
+     */
+    template <typename T>
+    [[nodiscard]] Polygon<T> ToPolygon(const Rectangle<T>& rectangle) noexcept
+    {
+        return Polygon<T>({
+            rectangle.MinBound(),
+            Vec2<T>(rectangle.MinBound().X, rectangle.MaxBound().Y),
+            rectangle.MaxBound(),
+            Vec2<T>(rectangle.MaxBound().X, rectangle.MinBound().Y)
+        });
+    }
+
     // Intersect functions
 
     template<typename T>
@@ -272,66 +433,248 @@ namespace Math
         return Intersect(rectangle, circle);
     }
 
+    /**
+     * @brief The contact between two overlapping shapes
+     */
     template <typename T>
-    [[nodiscard]] constexpr bool Intersect(const Polygon<T> polygon1, const Polygon<T> polygon2) noexcept
+    struct ContactManifold
     {
-        // Separate axis theorem
-        // Check if any of the edges of polygon1 is a separating axis
-        for (int i = 0, j = polygon1.VerticesCount() - 1; i < polygon1.VerticesCount(); j = i++)
-        {
-            const auto edge = polygon1.Vertices()[i] - polygon1.Vertices()[j];
-            const auto normal = Vec2<T>(-edge.Y, edge.X);
+        /**
+         * @brief The direction to move the first shape out of the second one
+         */
+        Vec2<T> Normal {Vec2<T>::Zero()};
+        T Penetration {};
+        std::array<Vec2<T>, 2> Points {};
+        int PointCount {0};
+    };
 
-            const auto startProjection1 = polygon1.Vertices()[0].Dot(normal);
-            const auto startProjection2 = polygon2.Vertices()[0].Dot(normal);
+    /**
+     * @brief Project vertices on an axis, 4 vertices at a time
+     * @param vertices the vertices to project, at least one
+     * @param axis the axis to project on
+     * @return the min projection in X and the max projection in Y
+     */
+    template <typename T>
+    [[nodiscard]] Vec2<T> Project(std::span<const Vec2<T>> vertices, Vec2<T> axis) noexcept
+    {
+        const NVec2<T, 4> axes(axis);
+        auto min = vertices[0].Dot(axis);
+        auto max = min;
+        std::size_t i = 0;
 
-            Vec2<T> projection1 = Vec2<T>(startProjection1, startProjection1);
-            Vec2<T> projection2 = Vec2<T>(startProjection2, startProjection2);
+        for (; i + 4 <= vertices.size(); i += 4)
+        {
+            const auto projections = NVec2<T, 4>::Dot(NVec2<T, 4>({vertices[i], vertices[i + 1], vertices[i + 2], vertices[i + 3]}), axes);
 
-            for (const auto& vertex : polygon1.Vertices())
+            for (const auto projection : projections)
             {
-                const auto projection = vertex.Dot(normal);
-
-                projection1 = Vec2<T>(Math::Min(projection1.X, projection), Math::Max(projection1.Y, projection));
+                min = Math::Min(min, projection);
+                max = Math::Max(max, projection);
             }
+        }
+
+        for (; i < vertices.size(); i++)
+        {
+            const auto projection = vertices[i].Dot(axis);
+
+            min = Math::Min(min, projection);
+            max = Math::Max(max, projection);
+        }
 
-            for (const auto& vertex : polygon2.Vertices())
+        return Vec2<T>(min, max);
+    }
+
+    /**
+     * @brief Check the normals of the edges of a polygon as separating axes of two polygons (separate axis theorem)
+     * @param normals the normals of the edges of one of the two polygons
+     * @param vertices1 the vertices of the first polygon
+     * @param vertices2 the vertices of the second polygon
+     * @param axis the axis where the polygons overlap the least, only replaced by a smaller overlap
+     * @param overlap the overlap of the polygons along the axis
+     * @param edge the index of the normal of the axis
+     * @return false if one of the edges separates the polygons
+     */
+    template <typename T>
+    [[nodiscard]] bool FindSmallestOverlap(std::span<const Vec2<T>> normals, std::span<const Vec2<T>> vertices1,
+        std::span<const Vec2<T>> vertices2, Vec2<T>& axis, T& overlap, std::size_t& edge) noexcept
+    {
+        for (std::size_t i = 0; i < normals.size(); i++)
+        {
+            const auto& normal = normals[i];
+
+            if (normal == Vec2<T>::Zero()) continue;
+
+            const auto projection1 = Project(vertices1, normal);
+            const auto projection2 = Project(vertices2, normal);
+
+            if (projection1.Y < projection2.X || projection2.Y < projection1.X) return false;
+
+            auto normalOverlap = Math::Min(projection1.Y - projection2.X, projection2.Y - projection1.X);
+
+            // The normals of the integer polygons are not normalized
+            if constexpr (!std::is_floating_point_v<T>)
             {
-                const auto projection = vertex.Dot(normal);
+                normalOverlap /= normal.Length();
+            }
 
-                projection2 = Vec2<T>(Math::Min(projection2.X, projection), Math::Max(projection2.Y, projection));
+            if (normalOverlap < overlap)
+            {
+                axis = normal;
+                overlap = normalOverlap;
+                edge = i;
             }
+        }
 
-            if (projection1.Y < projection2.X || projection2.Y < projection1.X) return false;
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool Intersect(const Polygon<T>& polygon1, const Polygon<T>& polygon2) noexcept
+    {
+        const auto vertices1 = polygon1.Vertices();
+        const auto vertices2 = polygon2.Vertices();
+        auto axis = Vec2<T>::Zero();
+        auto overlap = std::numeric_limits<T>::max();
+        std::size_t edge = 0;
+
+        // The polygons overlap if no edge of any of them is a separating axis
+        return FindSmallestOverlap(polygon1.Normals(), vertices1, vertices2, axis, overlap, edge) &&
+            FindSmallestOverlap(polygon2.Normals(), vertices1, vertices2, axis, overlap, edge);
+    }
+
+    /**
+     * @brief Find the contact of two convex polygons. The edge of the axis of the smallest overlap is the reference face,
+     * the edge of the other polygon that faces it the most is clipped by its sides to get the contact points
+     * @param polygon1 the first polygon
+     * @param polygon2 the second polygon
+     * @param manifold the contact, with the normal pointing from the second polygon to the first one
+     * @return true if the polygons overlap
+     */
+    template <typename T>
+    [[nodiscard]] bool FindContact(const Polygon<T>& polygon1, const Polygon<T>& polygon2, ContactManifold<T>& manifold) noexcept
+    {
+        const auto vertices1 = polygon1.Vertices();
+        const auto vertices2 = polygon2.Vertices();
+        auto axis1 = Vec2<T>::Zero();
+        auto axis2 = Vec2<T>::Zero();
+        auto overlap1 = std::numeric_limits<T>::max();
+        auto overlap2 = std::numeric_limits<T>::max();
+        std::size_t edge1 = 0;
+        std::size_t edge2 = 0;
+
+        if (!FindSmallestOverlap(polygon1.Normals(), vertices1, vertices2, axis1, overlap1, edge1)) return false;
+        if (!FindSmallestOverlap(polygon2.Normals(), vertices1, vertices2, axis2, overlap2, edge2)) return false;
+        if (overlap1 == std::numeric_limits<T>::max() && overlap2 == std::numeric_limits<T>::max()) return false;
+
+        const auto firstIsReference = overlap1 <= overlap2;
+        const auto& referencePolygon = firstIsReference ? polygon1 : polygon2;
+        const auto& reference = firstIsReference ? vertices1 : vertices2;
+        const auto& incident = firstIsReference ? vertices2 : vertices1;
+        auto normal = firstIsReference ? axis1 : axis2;
+
+        if (normal.Dot(polygon1.Center() - polygon2.Center()) < 0)
+        {
+            normal = -normal;
         }
 
-        // Check if any of the edges of polygon2 is a separating axis
-        for (int i = 0, j = polygon2.VerticesCount() - 1; i < polygon2.VerticesCount(); j = i++)
+        manifold.Normal = normal;
+        manifold.Penetration = firstIsReference ? overlap1 : overlap2;
+        manifold.PointCount = 0;
+
+        // The normal of the reference face going out of the reference polygon, towards the incident one
+        const auto faceNormal = firstIsReference ? -normal : normal;
+
+        // The parallel edges of the polygon overlap as much as the edge found, the reference face is the one that faces the incident polygon
+        const auto normals = referencePolygon.Normals();
+        const auto referenceCenter = referencePolygon.Center();
+        auto edge = firstIsReference ? edge1 : edge2;
+        auto bestFacing = std::numeric_limits<T>::lowest();
+
+        for (std::size_t i = 0; i < normals.size(); i++)
         {
-            const auto edge = polygon2.Vertices()[i] - polygon2.Vertices()[j];
-            const auto normal = Vec2<T>(-edge.Y, edge.X);
+            if (normals[i] == Vec2<T>::Zero()) continue;
 
-            const auto startProjection1 = polygon1.Vertices()[0].Dot(normal);
-            const auto startProjection2 = polygon2.Vertices()[0].Dot(normal);
+            // The normals point in or out depending on the winding of the polygon
+            const auto edgeCenter = reference[i == 0 ? reference.size() - 1 : i - 1] + reference[i];
+            const auto outside = normals[i].Dot(edgeCenter - referenceCenter * T(2)) < 0 ? -normals[i] : normals[i];
+            auto facing = outside.Dot(faceNormal);
 
-            Vec2<T> projection1 = Vec2<T>(startProjection1, startProjection1);
-            Vec2<T> projection2 = Vec2<T>(startProjection2, startProjection2);
+            // The normals of the integer polygons are not normalized
+            if constexpr (!std::is_floating_point_v<T>)
+            {
+                facing /= outside.Length();
+            }
 
-            for (const auto& vertex : polygon1.Vertices())
+            if (facing > bestFacing)
             {
-                const auto projection = vertex.Dot(normal);
+                bestFacing = facing;
+                edge = i;
+            }
+        }
+
+        const auto faceStart = reference[edge == 0 ? reference.size() - 1 : edge - 1];
+        const auto faceEnd = reference[edge];
+
+        // The incident edge is next to the deepest vertex, on the side the most parallel to the reference face
+        std::size_t deepest = 0;
 
-                projection1 = Vec2<T>(Math::Min(projection1.X, projection), Math::Max(projection1.Y, projection));
+        for (std::size_t i = 1; i < incident.size(); i++)
+        {
+            if (incident[i].Dot(faceNormal) < incident[deepest].Dot(faceNormal))
+            {
+                deepest = i;
             }
+        }
+
+        const auto previous = incident[deepest == 0 ? incident.size() - 1 : deepest - 1];
+        const auto next = incident[(deepest + 1) % incident.size()];
+        const auto deepestVertex = incident[deepest];
+        const auto getAlignment = [&faceNormal](Vec2<T> edgeVector) {
+            const auto length = edgeVector.Length();
+
+            return length == 0 ? T(1) : std::abs(edgeVector.Dot(faceNormal)) / length;
+        };
+        const auto previousAlignment = getAlignment(deepestVertex - previous);
+        const auto nextAlignment = getAlignment(next - deepestVertex);
+        std::array<Vec2<T>, 2> points = previousAlignment <= nextAlignment ?
+            std::array<Vec2<T>, 2>{previous, deepestVertex} : std::array<Vec2<T>, 2>{deepestVertex, next};
 
-            for (const auto& vertex : polygon2.Vertices())
+        // Clip the incident edge by the sides of the reference face
+        const auto tangent = (faceEnd - faceStart).Normalized();
+        const auto clip = [&points](Vec2<T> direction, T offset) {
+            const auto distance0 = points[0].Dot(direction) - offset;
+            const auto distance1 = points[1].Dot(direction) - offset;
+
+            if (distance0 < 0 && distance1 < 0) return false;
+
+            if (distance0 < 0)
+            {
+                points[0] = points[0] + (points[1] - points[0]) * (distance0 / (distance0 - distance1));
+            }
+            else if (distance1 < 0)
             {
-                const auto projection = vertex.Dot(normal);
+                points[1] = points[1] + (points[0] - points[1]) * (distance1 / (distance1 - distance0));
+            }
 
-                projection2 = Vec2<T>(Math::Min(projection2.X, projection), Math::Max(projection2.Y, projection));
+            return true;
+        };
+
+        if (clip(tangent, faceStart.Dot(tangent)) && clip(-tangent, -faceEnd.Dot(tangent)))
+        {
+            const auto faceOffset = faceStart.Dot(faceNormal);
+
+            for (const auto& point : points)
+            {
+                if (point.Dot(faceNormal) <= faceOffset)
+                {
+                    manifold.Points[manifold.PointCount++] = point;
+                }
             }
+        }
 
-            if (projection1.Y < projection2.X || projection2.Y < projection1.X) return false;
+        if (manifold.PointCount == 0)
+        {
+            manifold.Points[manifold.PointCount++] = deepestVertex;
         }
 
         return true;
@@ -355,7 +698,7 @@ namespace Math
     }
 
     template <typename T>
-    [[nodiscard]] constexpr bool Intersect(const Polygon<T> polygon, const Circle<T> circle) noexcept
+    [[nodiscard]] constexpr bool Intersect(const Polygon<T>& polygon, const Circle<T> circle) noexcept
     {
         const auto center = circle.Center();
         const auto radius = circle.Radius();
@@ -387,27 +730,93 @@ namespace Math
     }
 
     template <typename T>
-    [[nodiscard]] constexpr bool Intersect(const Circle<T> circle, const Polygon<T> polygon) noexcept
+    [[nodiscard]] constexpr bool Intersect(const Circle<T> circle, const Polygon<T>& polygon) noexcept
     {
         return Intersect(polygon, circle);
     }
 
     template <typename T>
-    [[nodiscard]] constexpr bool Intersect(const Polygon<T> polygon, const Rectangle<T> rectangle) noexcept
+    [[nodiscard]] constexpr bool Intersect(const Polygon<T>& polygon, const Rectangle<T> rectangle) noexcept
     {
-        Polygon<T> rectToPolygon = Polygon<T>({
-            rectangle.MinBound(),
-            Vec2<T>(rectangle.MinBound().X, rectangle.MaxBound().Y),
-            rectangle.MaxBound(),
-            Vec2<T>(rectangle.MaxBound().X, rectangle.MinBound().Y)
-        });
-
-        return Intersect(polygon, rectToPolygon);
+        return Intersect(polygon, ToPolygon(rectangle));
     }
 
     template <typename T>
-    [[nodiscard]] constexpr bool Intersect(const Rectangle<T> rectangle, const Polygon<T> polygon) noexcept
+    [[nodiscard]] constexpr bool Intersect(const Rectangle<T> rectangle, const Polygon<T>& polygon) noexcept
     {
         return Intersect(polygon, rectangle);
     }
+
+    /**
+     * @brief Find the contact of a circle and a convex polygon, from the point of the polygon the closest to the center of the circle
+     * @param circle the circle
+     * @param polygon the polygon
+     * @param manifold the contact, with the normal pointing from the polygon to the circle
+     * @return true if the shapes overlap
+     */
+    template <typename T>
+    [[nodiscard]] bool FindContact(const Circle<T>& circle, const Polygon<T>& polygon, ContactManifold<T>& manifold) noexcept
+    {
+        const auto vertices = polygon.Vertices();
+        const auto center = circle.Center();
+        auto closest = vertices[0];
+        auto closestSquareDistance = std::numeric_limits<T>::max();
+
+        for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+        {
+            const auto point = vertices[i] == vertices[j] ? vertices[i] : ClosestPointOnSegment(vertices[j], vertices[i], center);
+            const auto squareDistance = (center - point).SquareLength();
+
+            if (squareDistance < closestSquareDistance)
+            {
+                closest = point;
+                closestSquareDistance = squareDistance;
+            }
+        }
+
+        const auto inside = polygon.Contains(center);
+        const auto distance = std::sqrt(closestSquareDistance);
+
+        if (!inside && distance > circle.Radius()) return false;
+
+        if (distance == 0)
+        {
+            // The center is on the border, it is pushed out of the polygon from its center
+            const auto fromCenter = center - polygon.Center();
+
+            manifold.Normal = fromCenter == Vec2<T>::Zero() ? Vec2<T>::Up() : fromCenter.Normalized();
+        }
+        else
+        {
+            manifold.Normal = (inside ? closest - center : center - closest) / distance;
+        }
+
+        manifold.Penetration = inside ? circle.Radius() + distance : circle.Radius() - distance;
+        manifold.Points[0] = closest;
+        manifold.PointCount = 1;
+
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool FindContact(const Polygon<T>& polygon, const Circle<T>& circle, ContactManifold<T>& manifold) noexcept
+    {
+        if (!FindContact(circle, polygon, manifold)) return false;
+
+        manifold.Normal = -manifold.Normal;
+
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool FindContact(const Polygon<T>& polygon, const Rectangle<T>& rectangle, ContactManifold<T>& manifold) noexcept
+    {
+        return FindContact(polygon, ToPolygon(rectangle), manifold);
+    }
+
+    template <typename T>
+    [[nodiscard]] bool FindContact(const Rectangle<T>& rectangle, const Polygon<T>& polygon, ContactManifold<T>& manifold) noexcept
+    {
+        return FindContact(ToPolygon(rectangle), polygon, manifold);
+    }
 }
\ No newline at end of file
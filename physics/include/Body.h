@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BodyType.h"
+#include "BodyStorage.h"
 
 #include "Vec2.h"
 
@@ -8,6 +9,7 @@ namespace Physics
 {
     /**
      * @brief A body is a point in space with a velocity and a mass that can be affected by forces.
+     * @note A body of a world keeps its values in the storage of the world, a copy of it refers to the same body.
      */
 	class Body
 	{
@@ -19,8 +21,20 @@ namespace Physics
          * @param velocity The velocity of the body
          */
 		Body(Math::Vec2F position, Math::Vec2F velocity) noexcept;
+		/**
+		 * @brief Construct a body that refers to the values of a body in a storage
+		 * @param storage The storage of the bodies
+		 * @param index The index of the body in the storage
+		 */
+		Body(BodyStorage* storage, std::size_t index) noexcept;
 
 	private:
+		/**
+		 * @brief The storage of the values, null for a body outside a world which keeps its own values
+		 */
+		BodyStorage* _storage { nullptr };
+		std::size_t _index { 0 };
+
 		Math::Vec2F _position = Math::Vec2F(0, 0);
 		Math::Vec2F _velocity = Math::Vec2F(0, 0);
 		Math::Vec2F _force = Math::Vec2F(0, 0);
@@ -28,6 +42,8 @@ namespace Physics
 		float _inverseMass = 0.f;
         BodyType _bodyType = BodyType::Dynamic;
         bool _useGravity { false };
+        bool _awake { true };
+        bool _isBullet { false };
 
 	public:
         /**
@@ -65,9 +81,24 @@ namespace Physics
          * @return The use gravity of the body
          */
         [[nodiscard]] bool UseGravity() const noexcept;
+        /**
+         * @brief Check if the body is awake, a sleeping body is not moved by the world until something wakes it up
+         * @return true if the body is awake
+         */
+        [[nodiscard]] bool IsAwake() const noexcept;
+        /**
+         * @brief Check if the body is a bullet, a fast body that does not pass through the other bodies between two updates
+         * @return true if the body is a bullet
+         */
+        [[nodiscard]] bool IsBullet() const noexcept;
 
         /**
-         * @brief Set the position of the body
+         * @brief Wake up the body, setting or adding a position, a velocity or a force also wakes it up
+         */
+        void WakeUp() noexcept;
+
+        /**
+         * @brief Set the position of the body, the body is not interpolated from its last position
          * @param position The new position of the body
          */
 		void SetPosition(Math::Vec2F position) noexcept;
@@ -97,6 +128,11 @@ namespace Physics
          * @param useGravity The new use gravity of the body
          */
         void SetUseGravity(bool useGravity) noexcept;
+        /**
+         * @brief Set if the body is a bullet, the colliders of a bullet are swept along its move to find the first collider they touch
+         * @param isBullet True to make the body a bullet
+         */
+        void SetBullet(bool isBullet) noexcept;
 
         /**
          * @brief Apply a force to the body (add it to the current force)
@@ -104,7 +140,7 @@ namespace Physics
          */
 		void AddForce(Math::Vec2F force) noexcept;
         /**
-         * @brief Add a velocity to the body (add it to the current velocity)
+         * @brief Add a velocity to the body (add it to the current velocity), a static body does not move
          * @param velocity The velocity to add
          */
         void AddVelocity(Math::Vec2F velocity) noexcept;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BodyType.h"
+
+#include "Allocator.h"
+
+#include <cstdint>
+
+namespace Physics
+{
+	/**
+	 * @brief The values of the bodies of a world stored by field, indexed by the body index, to integrate several bodies at a time
+	 */
+	struct BodyStorage
+	{
+		explicit BodyStorage(HeapAllocator& allocator) noexcept;
+
+		MyVector<float> PositionsX;
+		MyVector<float> PositionsY;
+		/**
+		 * @brief The positions before the last fixed update of the world, to interpolate the positions between fixed updates
+		 */
+		MyVector<float> PreviousPositionsX;
+		MyVector<float> PreviousPositionsY;
+		MyVector<float> VelocitiesX;
+		MyVector<float> VelocitiesY;
+		MyVector<float> ForcesX;
+		MyVector<float> ForcesY;
+		MyVector<float> Masses;
+		/**
+		 * @brief 0 for the bodies that are not dynamic or not enabled, they are not accelerated
+		 */
+		MyVector<float> InverseMasses;
+		/**
+		 * @brief 1 for the bodies that use gravity, 0 otherwise
+		 */
+		MyVector<float> GravityScales;
+		/**
+		 * @brief 1 for the awake bodies, 0 for the sleeping ones, they are not accelerated
+		 */
+		MyVector<float> AwakeScales;
+		/**
+		 * @brief The number of updates since the body is slower than the sleep velocity
+		 */
+		MyVector<std::size_t> SleepFrames;
+		/**
+		 * @brief 1 for the bodies moved or given a collider since the last update, their pairs with the sleeping bodies are checked again
+		 */
+		MyVector<std::uint8_t> Changed;
+		/**
+		 * @brief 1 for the bullet bodies, their colliders are swept to not pass through the other colliders
+		 */
+		MyVector<std::uint8_t> Bullets;
+		/**
+		 * @brief The number of bullet bodies, kept by the bodies when they are set as bullets
+		 */
+		std::size_t BulletCount { 0 };
+		MyVector<BodyType> Types;
+
+		/**
+		 * @brief Add or remove bodies at the end, the new bodies are disabled and awake
+		 * @param size The new number of bodies
+		 */
+		void Resize(std::size_t size) noexcept;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ColliderPair.h"
+#include "Shape.h"
+
+#include "Allocator.h"
+#include "ThreadPool.h"
+
+#include <span>
+#include <vector>
+
+namespace Physics
+{
+	/**
+	 * @brief A simplified collider that only contains the collider reference and the collider bounds (rectangle)
+	 */
+	struct SimplifiedCollider
+	{
+		ColliderRef Ref {};
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::One()};
+	};
+
+	/**
+	 * @brief The available broad phases of the world
+	 */
+	enum class BroadPhaseType
+	{
+		QuadTree,
+		IncrementalQuadTree,
+		LooseQuadTree,
+		LinearQuadTree,
+		SweepAndPrune,
+		DynamicTree,
+		SpatialHash
+	};
+
+	/**
+	 * @brief A broad phase finds the pairs of colliders whose bounds overlap, the world then checks their real shapes
+	 */
+	class BroadPhase
+	{
+	public:
+		virtual ~BroadPhase() noexcept = default;
+
+		/**
+		 * @brief Update the broad phase with all the enabled colliders of the world.
+		 * A collider that was in the previous update but not in this one has been disabled or destroyed.
+		 * @param colliders The enabled colliders, at most one per collider index
+		 */
+		virtual void Update(std::span<const SimplifiedCollider> colliders) noexcept = 0;
+		/**
+		 * @brief Get all the pairs of colliders whose bounds overlap, each pair is only given once
+		 * @return All the possible pairs of colliders
+		 */
+		[[nodiscard]] virtual const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept = 0;
+		/**
+		 * @brief Get the boundaries used by the broad phase to split the space, used for debug drawing
+		 * @return All the boundaries
+		 */
+		[[nodiscard]] virtual std::vector<Math::RectangleF> GetBoundaries() const noexcept = 0;
+		/**
+		 * @brief Find the colliders of the last update whose bounds overlap the given bounds, each collider is only given once
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to, they are not cleared
+		 */
+		virtual void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept = 0;
+
+		/**
+		 * @brief Set the threads the broad phase can use, it runs on the calling thread by default
+		 * @param threadPool The thread pool, or nullptr to only use the calling thread
+		 */
+		virtual void SetThreadPool([[maybe_unused]] ThreadPool* threadPool) noexcept {}
+	};
+}
\ No newline at end of file
@@ -1,22 +1,30 @@
 #pragma once
 
 #include "Shape.h"
+#include "ShapeStorage.h"
 #include "Ref.h"
 
-#include <variant>
-
 namespace Physics
 {
     /**
-     * @brief Collider class
+     * @brief Collider class. Its shape is kept in the pools of a shape storage, a collider without a shape storage has no shape
      */
 	class Collider
 	{
 	public:
 		constexpr Collider() noexcept = default;
+		/**
+		 * @brief Construct a collider whose shapes are kept in a shape storage
+		 * @param shapeStorage The shape storage, it must outlive the collider
+		 */
+		explicit Collider(ShapeStorage* shapeStorage) noexcept;
 
 	private:
-        std::variant<Math::CircleF, Math::RectangleF, Math::PolygonF> _shape { Math::CircleF(Math::Vec2F::Zero(), 1.f) };
+		ShapeStorage* _shapeStorage { nullptr };
+		/**
+		 * @brief The index of the shape in the pools of its type in the shape storage
+		 */
+		std::size_t _shapeIndex { 0 };
         Math::RectangleF _bounds { Math::Vec2F::Zero(), Math::Vec2F::One() };
 		BodyRef _bodyRef {};
 		ColliderRef _colliderRef {};
@@ -34,6 +42,16 @@ namespace Physics
 		 * @return the shape
 		 */
         [[nodiscard]] Math::RectangleF getBounds() const noexcept;
+        /**
+         * @brief Move the world shape to the position of the collider
+         */
+        void updateWorldShape() noexcept;
+        /**
+         * @brief Change the type of the shape, its index is taken in the pools of the new type
+         * @param type The new shape type
+         * @return False if the collider has no shape storage
+         */
+        bool setShapeType(Math::ShapeType type) noexcept;
 
 	public:
         /**
@@ -96,7 +114,7 @@ namespace Physics
         void SetOffset(Math::Vec2F offset) noexcept;
 
 		/**
-		 * @brief Set the position of the collider
+		 * @brief Set the position of the collider and move its world shape there
 		 * @param position the position
 		 */
 		void SetPosition(Math::Vec2F position) noexcept;
@@ -113,7 +131,7 @@ namespace Physics
 		void SetIsTrigger(bool isTrigger) noexcept;
 
         /**
-         * @brief Set the shape of the collider to a circle, the circle center is not used
+         * @brief Set the shape of the collider to a circle, the circle center is relative to the position of the collider
          * @param circle the circle
          */
 		void SetCircle(Math::CircleF circle) noexcept;
@@ -137,7 +155,7 @@ namespace Physics
          */
 		void Disable() noexcept;
 		/**
-		 * @brief Free the collider (reset its values)
+		 * @brief Free the collider (reset its values and give its shape back to the shape storage)
 		 */
 		void Free() noexcept;
 
@@ -161,7 +179,22 @@ namespace Physics
          * @brief Get the polygon of the collider
          * @return the polygon
          */
-		[[nodiscard]] Math::PolygonF GetPolygon() const noexcept;
+		[[nodiscard]] const Math::PolygonF& GetPolygon() const noexcept;
+        /**
+         * @brief Get the circle of the collider at the position of the collider
+         * @return the circle in world space
+         */
+		[[nodiscard]] const Math::CircleF& GetWorldCircle() const noexcept;
+        /**
+         * @brief Get the rectangle of the collider at the position of the collider
+         * @return the rectangle in world space
+         */
+		[[nodiscard]] const Math::RectangleF& GetWorldRectangle() const noexcept;
+        /**
+         * @brief Get the polygon of the collider at the position of the collider
+         * @return the polygon in world space
+         */
+		[[nodiscard]] const Math::PolygonF& GetWorldPolygon() const noexcept;
 		/**
 		 * @brief Get the shape of the collider with the correct position
 		 * @return the shape
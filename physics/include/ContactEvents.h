@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ColliderPair.h"
+
+#include "Allocator.h"
+
+namespace Physics
+{
+	/**
+	 * @brief The kinds of contact events a world writes to its event buffers, all of them are off by default
+	 */
+	struct ContactEventTypes
+	{
+		bool Enter {false};
+		bool Stay {false};
+		bool Exit {false};
+	};
+
+	/**
+	 * @brief The contact events of the last call to Update or Advance of a world, in the same order as the calls of the contact listener.
+	 * Each event is the pair of colliders, with the collider with the lowest index first
+	 */
+	struct ContactEvents
+	{
+		explicit ContactEvents(HeapAllocator& allocator) noexcept;
+
+		MyVector<ColliderPair> TriggerEnters;
+		MyVector<ColliderPair> TriggerStays;
+		MyVector<ColliderPair> TriggerExits;
+		MyVector<ColliderPair> CollisionEnters;
+		MyVector<ColliderPair> CollisionStays;
+		MyVector<ColliderPair> CollisionExits;
+
+		/**
+		 * @brief Remove all the events, the buffers keep their capacity
+		 */
+		void Clear() noexcept;
+	};
+}
\ No newline at end of file
@@ -6,7 +6,8 @@
 namespace Physics
 {
 	/**
-	 * @brief A contact resolver is used to resolve the collision between two bodies
+	 * @brief A contact resolver is used to resolve the collision between two bodies.
+	 * The velocity is solved by accumulating impulses over several iterations, starting from the impulse of the last update.
 	 */
 	class ContactResolver
 	{
@@ -29,6 +30,18 @@ namespace Physics
 
 		Math::Vec2F _normal { Math::Vec2F::Zero() };
 		float _penetration { 0.f };
+		/**
+		 * @brief The separating velocity to reach, from the restitution of the colliders
+		 */
+		float _targetVelocity { 0.f };
+		/**
+		 * @brief The impulse applied along the normal since the contact was prepared, never negative
+		 */
+		float _normalImpulse { 0.f };
+		/**
+		 * @brief False when a collider has no shape or when the polygon of a collider does not touch the other shape
+		 */
+		bool _isActive { false };
 
 	public:
 		/**
@@ -36,19 +49,36 @@ namespace Physics
 		 */
 		void ResolveContact() noexcept;
 
+		/**
+		 * @brief Calculate the normal and the penetration of the contact, then apply the impulse of the last update
+		 * @param warmImpulse The impulse accumulated on the contact in the last update, 0 for a new contact
+		 */
+		void PrepareContact(float warmImpulse) noexcept;
+		/**
+		 * @brief Apply the impulse that brings the separating velocity to its target, the accumulated impulse never pulls the bodies together
+		 */
+		void SolveVelocity() noexcept;
+		/**
+		 * @brief Move the bodies apart by the penetration of the contact
+		 */
+		void SolvePosition() noexcept;
+
+		/**
+		 * @brief Get the impulse accumulated along the normal, to warm start the contact in the next update
+		 * @return The accumulated impulse
+		 */
+		[[nodiscard]] float GetNormalImpulse() const noexcept;
+
 	private:
 		/**
 		 * @brief Setup the contact between the two colliders
 		 */
 		void setupContact() noexcept;
 		/**
-		 * @brief Resolve the collision between the two colliders
-		 */
-		void resolveCollision() noexcept;
-		/**
-		 * @brief Resolve the position of the two colliders
+		 * @brief Apply an impulse along the normal to the dynamic bodies
+		 * @param impulse The impulse to apply
 		 */
-		void resolvePosition() noexcept;
+		void applyImpulse(float impulse) noexcept;
 
 		/**
 		 * @brief Resolve the collision between two circles
@@ -62,5 +92,9 @@ namespace Physics
 		 * @brief Resolve the collision between a circle and a rectangle
 		 */
 		void resolveCircleToRectangle() noexcept;
+		/**
+		 * @brief Resolve the collision between a polygon and any shape with the separate axis theorem, inactive if they do not touch
+		 */
+		void resolvePolygonContact() noexcept;
 	};
 }
\ No newline at end of file
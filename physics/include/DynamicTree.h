@@ -0,0 +1,147 @@
+#pragma once
+
+#include "BroadPhase.h"
+
+#include "Allocator.h"
+
+#include <limits>
+
+namespace Physics
+{
+	/**
+	 * @brief A node of the dynamic tree, a leaf contains a collider and the other nodes contain the bounds of their two children
+	 */
+	struct DynamicTreeNode
+	{
+		/**
+		 * @brief The enlarged bounds of the collider for a leaf, the bounds of the children otherwise
+		 */
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		ColliderRef Ref {};
+		/**
+		 * @brief The parent of the node, or the next free node if the node is free
+		 */
+		std::size_t Parent {};
+		std::size_t Child1 {};
+		std::size_t Child2 {};
+		/**
+		 * @brief 0 for a leaf, -1 for a free node
+		 */
+		int Height {-1};
+	};
+
+	/**
+	 * @brief A collider kept by the dynamic tree between updates
+	 */
+	struct DynamicTreeProxy
+	{
+		std::size_t Leaf {};
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		std::size_t LastUpdate {0};
+	};
+
+	/**
+	 * @brief A dynamic bounding volume hierarchy. Each collider is stored with bounds enlarged in the direction it moves,
+	 * it is only inserted again when its bounds leave them. The tree is kept balanced with rotations.
+	 */
+	class DynamicTree final : public BroadPhase
+	{
+	public:
+		DynamicTree() noexcept;
+
+	private:
+		HeapAllocator _heapAllocator {};
+		MyVector<DynamicTreeNode> _nodes { StandardAllocator<DynamicTreeNode> {_heapAllocator} };
+		/**
+		 * @brief The colliders, indexed by the collider index
+		 */
+		MyVector<DynamicTreeProxy> _proxies { StandardAllocator<DynamicTreeProxy> {_heapAllocator} };
+		MyVector<ColliderPair> _allPossiblePairs { StandardAllocator<ColliderPair> {_heapAllocator} };
+
+		std::size_t _root;
+		std::size_t _freeList;
+		std::size_t _updateCount { 0 };
+
+		static constexpr std::size_t _nullNode = std::numeric_limits<std::size_t>::max();
+		/**
+		 * @brief Margin added around the bounds of a collider, in percent of its size
+		 */
+		static constexpr float _sizeMargin = 0.1f;
+		/**
+		 * @brief Number of updates of movement added to the bounds of a collider in the direction it moves
+		 */
+		static constexpr float _displacementMultiplier = 4.f;
+
+		[[nodiscard]] std::size_t allocateNode() noexcept;
+		void freeNode(std::size_t index) noexcept;
+		[[nodiscard]] bool isLeaf(std::size_t index) const noexcept;
+
+		void insertLeaf(std::size_t leaf) noexcept;
+		void removeLeaf(std::size_t leaf) noexcept;
+		/**
+		 * @brief Rotate the node if one of its children is higher than the other by more than one
+		 * @param index The node to balance
+		 * @return The node that took the place of the given one
+		 */
+		std::size_t balance(std::size_t index) noexcept;
+		/**
+		 * @brief Recompute the bounds and heights of the node and all its parents, balancing them on the way
+		 * @param index The first node to fix
+		 */
+		void fixUpwards(std::size_t index) noexcept;
+
+		/**
+		 * @brief Add the pairs of overlapping colliders inside a node
+		 */
+		void addAllPossiblePairs(std::size_t index) noexcept;
+		/**
+		 * @brief Add the pairs of overlapping colliders between two nodes
+		 */
+		void addAllPossiblePairs(std::size_t indexA, std::size_t indexB) noexcept;
+		/**
+		 * @brief Add the colliders of a node whose bounds overlap the given bounds
+		 */
+		void query(std::size_t index, const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept;
+
+		/**
+		 * @brief Enlarge the bounds of a collider by a margin and in the direction of its displacement
+		 */
+		[[nodiscard]] static Math::RectangleF fatten(const Math::RectangleF& bounds, Math::Vec2F displacement) noexcept;
+		[[nodiscard]] static Math::RectangleF combine(const Math::RectangleF& a, const Math::RectangleF& b) noexcept;
+		[[nodiscard]] static float perimeter(const Math::RectangleF& bounds) noexcept;
+
+	public:
+		/**
+		 * @brief Add and remove the colliders, insert again the ones that left their enlarged bounds
+		 * @param colliders The enabled colliders
+		 */
+		void Update(std::span<const SimplifiedCollider> colliders) noexcept override;
+		/**
+		 * @brief Traverse the tree against itself to find all the pairs of colliders whose bounds overlap
+		 * @return All the possible pairs of colliders
+		 */
+		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept override;
+		/**
+		 * @brief Get the bounds of all the nodes of the tree
+		 * @return All the boundaries of the tree
+		 */
+		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept override;
+		/**
+		 * @brief Descend in the nodes that overlap the bounds
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to
+		 */
+		void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept override;
+
+		/**
+		 * @brief Get the number of colliders in the tree
+		 * @return The number of colliders
+		 */
+		[[nodiscard]] std::size_t GetCollidersCount() const noexcept;
+		/**
+		 * @brief Get the height of the tree, 0 if it only has one collider
+		 * @return The height of the tree
+		 */
+		[[nodiscard]] int GetHeight() const noexcept;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "BroadPhase.h"
+
+#include "Allocator.h"
+
+#include <cstdint>
+
+namespace Physics
+{
+	/**
+	 * @brief A node of the linear quadtree, its colliders and the colliders of its children are contiguous in the sorted colliders
+	 */
+	struct LinearQuadNode
+	{
+		/**
+		 * @brief The bounds of the colliders of the node and its children
+		 */
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		/**
+		 * @brief The bounds of the colliders of the node only
+		 */
+		Math::RectangleF OwnBounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		/**
+		 * @brief The first collider of the node
+		 */
+		std::uint32_t Begin {};
+		/**
+		 * @brief The end of the colliders of the node, the colliders of its children start there
+		 */
+		std::uint32_t OwnEnd {};
+		/**
+		 * @brief The end of the colliders of the node and its children
+		 */
+		std::uint32_t End {};
+		/**
+		 * @brief The node after the children of this node, the nodes are stored in depth first order
+		 */
+		std::uint32_t Next {};
+	};
+
+	/**
+	 * @brief A quadtree stored in flat arrays. The colliders are sorted each update by the Morton code of the cell they belong to with a radix sort,
+	 * each node is a contiguous range of the sorted colliders. A collider belongs to the deepest cell that contains its center and is bigger than it.
+	 */
+	class LinearQuadTree final : public BroadPhase
+	{
+	public:
+		LinearQuadTree() noexcept = default;
+
+	private:
+		HeapAllocator _heapAllocator {};
+		/**
+		 * @brief The colliders sorted by key
+		 */
+		MyVector<SimplifiedCollider> _colliders { StandardAllocator<SimplifiedCollider> {_heapAllocator} };
+		MyVector<std::uint32_t> _keys { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		MyVector<std::uint32_t> _indices { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		MyVector<std::uint32_t> _tempKeys { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		MyVector<std::uint32_t> _tempIndices { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		MyVector<LinearQuadNode> _nodes { StandardAllocator<LinearQuadNode> {_heapAllocator} };
+		MyVector<ColliderPair> _allPossiblePairs { StandardAllocator<ColliderPair> {_heapAllocator} };
+		/**
+		 * @brief The pairs found by each task, concatenated in the order of the tasks
+		 */
+		std::vector<MyVector<ColliderPair>> _taskPairs;
+		ThreadPool* _threadPool { nullptr };
+
+		/**
+		 * @brief The depth of the smallest cells, the key of a collider is its level on 4 bits and the Morton code of its cell on 2 * 14 bits
+		 */
+		static constexpr std::uint32_t _maxLevel = 14;
+		static constexpr std::uint32_t _levelBits = 4;
+		/**
+		 * @brief Number of nodes checked by one task
+		 */
+		static constexpr std::size_t _nodesPerTask = 16;
+
+		/**
+		 * @brief Spread the bits of a value to the even bits
+		 */
+		[[nodiscard]] static std::uint32_t spreadBits(std::uint32_t value) noexcept;
+		/**
+		 * @brief Sort the keys and the indices of the colliders with a radix sort on 8 bits at a time
+		 */
+		void radixSort() noexcept;
+		/**
+		 * @brief Add the node of a cell and its children
+		 * @param level The level of the cell
+		 * @param cell The Morton code of the first cell of the max level in the cell
+		 * @param begin The first collider in the cell
+		 * @param end The end of the colliders in the cell
+		 */
+		void build(std::uint32_t level, std::uint32_t cell, std::uint32_t begin, std::uint32_t end) noexcept;
+		/**
+		 * @brief Add the pairs of the colliders of two ranges whose bounds overlap
+		 * @param begin The first collider of the first range
+		 * @param end The end of the first range
+		 * @param otherBegin The first collider of the second range, after the first range
+		 * @param otherEnd The end of the second range
+		 * @param pairs The pairs to add to
+		 */
+		void addOverlappingPairs(std::size_t begin, std::size_t end, std::size_t otherBegin, std::size_t otherEnd, MyVector<ColliderPair>& pairs) const noexcept;
+		/**
+		 * @brief Add the pairs of the colliders of the nodes in a range with the colliders of the same node, of its children and of the next nodes
+		 * whose bounds overlap, each node is checked once against the nodes after it
+		 * @param begin The first node
+		 * @param end The end of the nodes
+		 * @param pairs The pairs to add to
+		 */
+		void addAllPossiblePairs(std::size_t begin, std::size_t end, MyVector<ColliderPair>& pairs) const noexcept;
+
+	public:
+		/**
+		 * @brief Sort the colliders and build the nodes
+		 * @param colliders The enabled colliders
+		 */
+		void Update(std::span<const SimplifiedCollider> colliders) noexcept override;
+		/**
+		 * @brief Check the colliders of each node against the colliders of the nodes after it that overlap them, split between the threads of the thread pool if there is one
+		 * @return All the possible pairs of colliders
+		 */
+		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept override;
+		/**
+		 * @brief Get the bounds of the nodes
+		 * @return All the boundaries of the nodes
+		 */
+		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept override;
+		/**
+		 * @brief Check the colliders of the nodes that overlap the bounds, skipping the children of the other nodes
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to
+		 */
+		void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept override;
+		/**
+		 * @brief Set the threads used to find the pairs
+		 * @param threadPool The thread pool, or nullptr to only use the calling thread
+		 */
+		void SetThreadPool(ThreadPool* threadPool) noexcept override;
+
+		/**
+		 * @brief Get the number of colliders in the quadtree
+		 * @return The number of colliders
+		 */
+		[[nodiscard]] std::size_t GetCollidersCount() const noexcept;
+		/**
+		 * @brief Get the number of nodes in the quadtree, the empty cells have no node
+		 * @return The number of nodes
+		 */
+		[[nodiscard]] std::size_t GetNodesCount() const noexcept;
+	};
+}
\ No newline at end of file
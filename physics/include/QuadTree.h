@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BroadPhase.h"
 #include "Collider.h"
 #include "ColliderPair.h"
 
@@ -7,58 +8,194 @@
 
 #include <vector>
 #include <memory>
+#include <limits>
 
 namespace Physics
 {
 	/**
-	 * @brief A simplified collider that only contains the collider reference and the collider bounds (rectangle)
-	 */
-    struct SimplifiedCollider
-    {
-        ColliderRef Ref {};
-        Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::One()};
-    };
-
-	/**
-	 * @brief A quadtree node that contains a boundary, a list of colliders and a boolean that indicates if the node has been divided
+	 * @brief A quadtree node that contains a boundary, the colliders and a boolean that indicates if the node has been divided.
+	 * The colliders bounds are stored in separate arrays to check them several at a time.
 	 */
     struct QuadNode
     {
 		explicit QuadNode(HeapAllocator& allocator) noexcept;
 
-	    MyVector<SimplifiedCollider> Colliders;
+	    MyVector<ColliderRef> Refs;
+	    MyVector<float> MinX;
+	    MyVector<float> MinY;
+	    MyVector<float> MaxX;
+	    MyVector<float> MaxY;
         Math::RectangleF Boundary {Math::Vec2F::Zero(), Math::Vec2F::One()};
+        /**
+         * @brief The boundary inflated by the looseness of the quadtree, the colliders of the node are inside it
+         */
+        Math::RectangleF LooseBoundary {Math::Vec2F::Zero(), Math::Vec2F::One()};
         bool Divided {false};
     };
 
+	/**
+	 * @brief A part of the colliders of a node to check against the colliders of the node and its children
+	 */
+	struct QuadPairTask
+	{
+		std::size_t Node {};
+		std::size_t Begin {};
+		std::size_t End {};
+	};
+
 	/**
 	 * @brief A quadtree that contains a list of quadtree nodes and a list of all possible pairs of colliders
 	 */
-	class QuadTree
+	class QuadTree final : public BroadPhase
 	{
 	public:
         /**
          * @brief Preallocate quadtree nodes with 4^MaxDepth nodes
          * @param boundary The boundary of the quadtree
+         * @param incremental True to keep the colliders between updates instead of rebuilding the quadtree each update
+         * @param looseness Factor applied to the size of the children boundaries, above 1 the colliders go in the child that contains their center
+         * instead of staying in the parent when they are on several children
          */
-		explicit QuadTree(const Math::RectangleF& boundary) noexcept;
+		explicit QuadTree(const Math::RectangleF& boundary, bool incremental = false, float looseness = 1.f) noexcept;
 
 	private:
 		LinearAllocator _nodesAllocator;
 		HeapAllocator _heapAllocator {};
 		MyVector<QuadNode> _nodes { StandardAllocator <QuadNode> {_nodesAllocator} };
 		MyVector<ColliderPair> _allPossiblePairs { StandardAllocator <ColliderPair> {_heapAllocator} };
+		/**
+		 * @brief Node index of each collider inserted with UpdateCollider, indexed by the collider index
+		 */
+		MyVector<std::size_t> _colliderNodes { StandardAllocator <std::size_t> {_heapAllocator} };
+		/**
+		 * @brief Position of each collider inserted with UpdateCollider in the arrays of its node, indexed by the collider index
+		 */
+		MyVector<std::size_t> _colliderSlots { StandardAllocator <std::size_t> {_heapAllocator} };
+		/**
+		 * @brief Last update in which each collider was given, indexed by the collider index
+		 */
+		MyVector<std::size_t> _colliderUpdates { StandardAllocator <std::size_t> {_heapAllocator} };
+		/**
+		 * @brief The colliders given in the last update and in this one, the ones of the last update that are not given again are removed
+		 */
+		MyVector<std::size_t> _lastUpdatedColliders { StandardAllocator <std::size_t> {_heapAllocator} };
+		MyVector<std::size_t> _updatedColliders { StandardAllocator <std::size_t> {_heapAllocator} };
+		/**
+		 * @brief The parts of the nodes to check in parallel, in the order of the nodes
+		 */
+		MyVector<QuadPairTask> _pairTasks { StandardAllocator <QuadPairTask> {_heapAllocator} };
+		/**
+		 * @brief The pairs found by each task, concatenated in the order of the tasks
+		 */
+		std::vector<MyVector<ColliderPair>> _taskPairs;
+		ThreadPool* _threadPool { nullptr };
+		std::size_t _updateCount { 0 };
+		bool _incremental { false };
+		float _looseness { 1.f };
 
         static constexpr std::size_t _maxDepth = 5;
 		static constexpr std::size_t _maxCapacity = 8;
+		static constexpr std::size_t _noNode = std::numeric_limits<std::size_t>::max();
+		/**
+		 * @brief Margin added around the colliders bounds when the boundary needs to grow, in percent of the size
+		 */
+		static constexpr float _growthMargin = 0.25f;
+		/**
+		 * @brief Max number of colliders of a node checked by one task
+		 */
+		static constexpr std::size_t _collidersPerTask = 32;
 
         static constexpr std::size_t getMaxNodes() noexcept;
         static constexpr std::size_t getDepth(std::size_t index) noexcept;
 
         void subdivide(std::size_t index) noexcept;
-		void addAllPossiblePairs(std::size_t index, const SimplifiedCollider& collider) noexcept;
+		void addAllPossiblePairs(std::size_t index, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept;
+		/**
+		 * @brief Add the pairs of a collider with the colliders of a loose node and of its children whose loose boundary overlaps the collider
+		 * @param index The node to check
+		 * @param begin The first collider of the node to check
+		 * @param collider The collider to check
+		 * @param pairs The pairs to add to
+		 */
+		void addLoosePairs(std::size_t index, std::size_t begin, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept;
+		/**
+		 * @brief Add the pairs of a collider with the colliders of a node whose bounds overlap, 8 colliders at a time with AVX
+		 * @param node The node to check
+		 * @param begin The first collider of the node to check
+		 * @param collider The collider to check
+		 * @param pairs The pairs to add to
+		 */
+		static void addOverlappingPairs(const QuadNode& node, std::size_t begin, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept;
+		/**
+		 * @brief Add the pairs of a part of the colliders of a node with the other colliders of the node and its children
+		 * @param task The node and the part of its colliders
+		 * @param pairs The pairs to add to
+		 */
+		void addAllPossiblePairs(const QuadPairTask& task, MyVector<ColliderPair>& pairs) noexcept;
+		/**
+		 * @brief Add the colliders of a node and its children whose bounds overlap the given bounds
+		 */
+		void query(std::size_t index, const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept;
+
+		/**
+		 * @brief Insert a collider starting from a node instead of the root
+		 * @param index The node to start from
+		 * @param collider The collider to insert
+		 */
+		void insert(std::size_t index, SimplifiedCollider collider) noexcept;
+		/**
+		 * @brief Get the child of a divided node that the bounds should go in
+		 * @param index The divided node
+		 * @param bounds The bounds to check
+		 * @return The child index, or index if the bounds are on more than one child or outside the loose boundary of the child
+		 */
+		[[nodiscard]] std::size_t getTargetChild(std::size_t index, const Math::RectangleF& bounds) const noexcept;
+		/**
+		 * @brief Check if the bounds are strictly inside the node boundary, the root accepts the bounds on its border.
+		 * A loose quadtree checks the loose boundary instead.
+		 */
+		[[nodiscard]] bool fits(std::size_t index, const Math::RectangleF& bounds) const noexcept;
+		/**
+		 * @brief Set the node and the position in it of a collider if it is tracked by UpdateCollider
+		 */
+		void setColliderSlot(ColliderRef colliderRef, std::size_t index, std::size_t position) noexcept;
+		/**
+		 * @brief Count the colliders of a node and all its children, stop counting when the limit is exceeded
+		 */
+		[[nodiscard]] std::size_t countColliders(std::size_t index, std::size_t limit) const noexcept;
+		/**
+		 * @brief Move all the colliders of the children of a node into it and undivide it
+		 */
+		void merge(std::size_t index) noexcept;
+		/**
+		 * @brief Merge the parents of a node that have less colliders than the max capacity
+		 */
+		void mergeParents(std::size_t index) noexcept;
+		/**
+		 * @brief Grow the boundary to contain all the tracked colliders and the new bounds, then insert them all again
+		 * @param collider The collider that is outside the boundary
+		 */
+		void rebuild(SimplifiedCollider collider) noexcept;
+
+		/**
+		 * @brief Add a collider at the end of a node and keep its slot if it is tracked
+		 */
+		void pushCollider(std::size_t index, const SimplifiedCollider& collider) noexcept;
+		[[nodiscard]] static SimplifiedCollider getCollider(const QuadNode& node, std::size_t position) noexcept;
+		void setCollider(std::size_t index, std::size_t position, const SimplifiedCollider& collider) noexcept;
+		/**
+		 * @brief Remove a collider of a node by replacing it with the last one, whose slot is updated
+		 */
+		void eraseCollider(std::size_t index, std::size_t position) noexcept;
+		static void resizeColliders(QuadNode& node, std::size_t count) noexcept;
 
     public:
+		/**
+		 * @brief Rebuild the quadtree with the colliders, or move them if the quadtree is incremental
+		 * @param colliders The enabled colliders
+		 */
+		void Update(std::span<const SimplifiedCollider> colliders) noexcept override;
+
 		/**
 		 * @brief Insert a collider into the quadtree, if the quadtree is full, subdivide the quadtree and insert the collider into the correct node
 		 * @param collider The collider to insert
@@ -66,10 +203,40 @@ namespace Physics
 		 */
 		void Insert(SimplifiedCollider collider) noexcept;
 		/**
-		 * @brief Get all the possible pairs of colliders in the quadtree
+		 * @brief Insert or move a collider that is kept between frames. The collider only moves when its bounds leave its node,
+		 * the nodes are divided when they are full and merged back when they are almost empty.
+		 * @param collider The collider to update
+		 */
+		void UpdateCollider(SimplifiedCollider collider) noexcept;
+		/**
+		 * @brief Remove a collider inserted with UpdateCollider, does nothing if the collider is not in the quadtree
+		 * @param colliderRef The collider to remove
+		 */
+		void RemoveCollider(ColliderRef colliderRef) noexcept;
+		/**
+		 * @brief Check if a collider has been inserted with UpdateCollider
+		 * @param colliderRef The collider to check
+		 * @return True if the collider is in the quadtree
+		 */
+		[[nodiscard]] bool Contains(ColliderRef colliderRef) const noexcept;
+
+		/**
+		 * @brief Get all the possible pairs of colliders in the quadtree, split between the threads of the thread pool if there is one.
+		 * The pairs are in the same order whatever the number of threads.
 		 * @return All the possible pairs of colliders in the quadtree
 		 */
-		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept;
+		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept override;
+		/**
+		 * @brief Set the threads used to find the pairs
+		 * @param threadPool The thread pool, or nullptr to only use the calling thread
+		 */
+		void SetThreadPool(ThreadPool* threadPool) noexcept override;
+		/**
+		 * @brief Descend in the nodes whose boundary overlaps the bounds
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to
+		 */
+		void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept override;
 
 		/**
 		 * @brief Set the new boundary of the quadtree, applies to all nodes
@@ -86,7 +253,12 @@ namespace Physics
 		 * @brief Get all the boundaries of the quadtree nodes that are not nullptr or empty
 		 * @return All the boundaries of the quadtree nodes
 		 */
-		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept;
+		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept override;
+		/**
+		 * @brief Get the looseness of the quadtree, 1 if the children boundaries are not inflated
+		 * @return The looseness
+		 */
+		[[nodiscard]] float GetLooseness() const noexcept;
 		/**
 		 * @brief Get the number of colliders in the quadtree and all its nodes
 		 * @return The number of colliders in the quadtree and all its nodes
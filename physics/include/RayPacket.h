@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Ref.h"
+#include "Shape.h"
+#include "NVec2.h"
+
+#include <array>
+#include <limits>
+#include <span>
+
+namespace Physics
+{
+	/**
+	 * @brief A ray or a segment to cast in the world, a segment is a ray going to its end with its length as max distance
+	 */
+	struct Ray
+	{
+		Math::Vec2F Origin {Math::Vec2F::Zero()};
+		/**
+		 * @brief The direction of the ray, it does not need to be normalized
+		 */
+		Math::Vec2F Direction {Math::Vec2F::Zero()};
+		float MaxDistance {std::numeric_limits<float>::max()};
+	};
+
+	/**
+	 * @brief The closest collider hit by a ray
+	 */
+	struct RayCastHit
+	{
+		ColliderRef Collider {};
+		Math::Vec2F Point {Math::Vec2F::Zero()};
+		Math::Vec2F Normal {Math::Vec2F::Zero()};
+		float Distance {};
+		bool Hit {false};
+	};
+
+	/**
+	 * @brief Up to 4 rays cast together, the shapes are tested against all the rays at once with SIMD.
+	 * Each ray keeps its closest hit, a ray that starts inside a shape does not hit it.
+	 */
+	class RayPacket
+	{
+	public:
+		/**
+		 * @brief Create a packet with the first rays of the span
+		 * @param rays The rays, only the first Size ones are used
+		 */
+		explicit RayPacket(std::span<const Ray> rays) noexcept;
+
+		static constexpr std::size_t Size = 4;
+
+	private:
+		Math::FourVec2F _origins;
+		/**
+		 * @brief The normalized directions
+		 */
+		Math::FourVec2F _directions;
+		/**
+		 * @brief The inverse of the directions, a zero component is replaced by a big value to keep the slab test without NaN
+		 */
+		Math::FourVec2F _inverseDirections;
+		/**
+		 * @brief The max distance of each ray, reduced to the distance of the closest hit. Negative for the unused rays
+		 */
+		std::array<float, Size> _maxDistances {};
+		std::array<RayCastHit, Size> _hits {};
+		Math::RectangleF _bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+
+		static constexpr float _bigInverse = 1e20f;
+
+		/**
+		 * @brief Keep a hit if it is closer than the current hit of the ray
+		 */
+		void addHit(std::size_t ray, ColliderRef colliderRef, float distance, Math::Vec2F normal) noexcept;
+		/**
+		 * @brief Slab test of the rays against a rectangle, 4 rays at a time
+		 * @param rectangle The rectangle to check
+		 * @param entryDistances The distance at which each ray enters the rectangle, negative if the ray starts inside it
+		 * @param entryOnX True for the rays that enter the rectangle by one of its vertical sides
+		 * @return A mask with a bit set for each ray that crosses the rectangle before its closest hit
+		 */
+		[[nodiscard]] int intersectBounds(const Math::RectangleF& rectangle, std::array<float, Size>& entryDistances, std::array<bool, Size>& entryOnX) const noexcept;
+
+	public:
+		/**
+		 * @brief Get the lanes of the rays that cross a rectangle before their closest hit
+		 * @param rectangle The rectangle to check
+		 * @return A mask with a bit set for each ray that crosses the rectangle
+		 */
+		[[nodiscard]] int IntersectBounds(const Math::RectangleF& rectangle) const noexcept;
+
+		/**
+		 * @brief Cast the rays against a rectangle collider
+		 * @param rectangle The rectangle in world space
+		 * @param colliderRef The collider of the rectangle
+		 */
+		void CastRectangle(const Math::RectangleF& rectangle, ColliderRef colliderRef) noexcept;
+		/**
+		 * @brief Cast the rays against a circle collider
+		 * @param circle The circle in world space
+		 * @param colliderRef The collider of the circle
+		 */
+		void CastCircle(const Math::CircleF& circle, ColliderRef colliderRef) noexcept;
+		/**
+		 * @brief Cast some of the rays against a polygon collider, one ray at a time
+		 * @param polygon The polygon in world space
+		 * @param colliderRef The collider of the polygon
+		 * @param mask The rays to cast, from IntersectBounds with the bounds of the polygon
+		 */
+		void CastPolygon(const Math::PolygonF& polygon, ColliderRef colliderRef, int mask) noexcept;
+
+		/**
+		 * @brief Get the bounds of all the rays of the packet, up to their max distance
+		 * @return The bounds of the rays
+		 */
+		[[nodiscard]] const Math::RectangleF& GetBounds() const noexcept;
+		/**
+		 * @brief Get the closest hit of each ray
+		 * @return The hits, one per ray of the packet
+		 */
+		[[nodiscard]] const std::array<RayCastHit, Size>& GetHits() const noexcept;
+	};
+}
\ No newline at end of file
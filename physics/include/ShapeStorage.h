@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Shape.h"
+
+#include "Allocator.h"
+
+namespace Physics
+{
+	/**
+	 * @brief The shapes of the colliders of a world in one dense pool per shape type, indexed by the shape index of the collider.
+	 * A collider of a type only uses the pools of its type, the circles stay packed together whatever the other shapes are
+	 */
+	struct ShapeStorage
+	{
+		explicit ShapeStorage(HeapAllocator& allocator) noexcept;
+
+		MyVector<Math::CircleF> Circles;
+		MyVector<Math::RectangleF> Rectangles;
+		MyVector<Math::PolygonF> Polygons;
+		/**
+		 * @brief The shapes moved to the position of their collider
+		 */
+		MyVector<Math::CircleF> WorldCircles;
+		MyVector<Math::RectangleF> WorldRectangles;
+		MyVector<Math::PolygonF> WorldPolygons;
+		/**
+		 * @brief The free indices of each pool, the last one is used first
+		 */
+		MyVector<std::size_t> FreeCircles;
+		MyVector<std::size_t> FreeRectangles;
+		MyVector<std::size_t> FreePolygons;
+
+		/**
+		 * @brief Take a free index in the pools of a shape type, the pools grow when they have none
+		 * @param type The shape type, not None
+		 * @return The index of the shape in the pools of its type
+		 */
+		[[nodiscard]] std::size_t Allocate(Math::ShapeType type) noexcept;
+		/**
+		 * @brief Give back an index of the pools of a shape type, a polygon is emptied
+		 * @param type The shape type, nothing is done for None
+		 * @param index The index of the shape in the pools of its type
+		 */
+		void Free(Math::ShapeType type, std::size_t index) noexcept;
+	};
+}
\ No newline at end of file
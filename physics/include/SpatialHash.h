@@ -0,0 +1,131 @@
+#pragma once
+
+#include "BroadPhase.h"
+
+#include "Allocator.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace Physics
+{
+	/**
+	 * @brief A collider stored in the spatial hash, with the cell that contains the min bound of its bounds
+	 */
+	struct SpatialHashEntry
+	{
+		ColliderRef Ref {};
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		std::int32_t CellX {};
+		std::int32_t CellY {};
+	};
+
+	/**
+	 * @brief A uniform grid broad phase with hashed cells, made for colliders of about the same size.
+	 * The colliders are sorted by cell with a counting sort at each update and each one is only checked against its cell and the neighbour cells.
+	 * The colliders bigger than a cell are kept apart and checked against all the others, a few big ones like a ground do not change the cells.
+	 */
+	class SpatialHash final : public BroadPhase
+	{
+	public:
+		/**
+		 * @brief Create a spatial hash
+		 * @param cellSize The size of the cells, 0 to use twice the median size of the colliders
+		 */
+		explicit SpatialHash(float cellSize = 0.f) noexcept;
+
+	private:
+		HeapAllocator _heapAllocator {};
+		/**
+		 * @brief The colliders sorted by bucket
+		 */
+		MyVector<SpatialHashEntry> _entries { StandardAllocator<SpatialHashEntry> {_heapAllocator} };
+		/**
+		 * @brief The index of the first entry of each bucket, the last one is the number of entries
+		 */
+		MyVector<std::uint32_t> _bucketStarts { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		/**
+		 * @brief The bucket of each collider given in the last update
+		 */
+		MyVector<std::uint32_t> _colliderBuckets { StandardAllocator<std::uint32_t> {_heapAllocator} };
+		/**
+		 * @brief The colliders bigger than a cell, they are not in the cells
+		 */
+		MyVector<SimplifiedCollider> _largeColliders { StandardAllocator<SimplifiedCollider> {_heapAllocator} };
+		/**
+		 * @brief The size of each collider, to find the median size when the cell size is not given
+		 */
+		MyVector<float> _colliderSizes { StandardAllocator<float> {_heapAllocator} };
+		MyVector<ColliderPair> _allPossiblePairs { StandardAllocator<ColliderPair> {_heapAllocator} };
+
+		float _cellSize;
+		float _usedCellSize { 0.f };
+		std::uint32_t _bucketMask { 0 };
+
+		/**
+		 * @brief The bucket of the colliders bigger than a cell
+		 */
+		static constexpr std::uint32_t _largeBucket = std::numeric_limits<std::uint32_t>::max();
+
+		/**
+		 * @brief Check if a collider is small enough to only overlap the colliders of its cell and the neighbour cells.
+		 * The size is raised a little to stay safe from rounding errors when computing the cells, NaN bounds do not fit
+		 */
+		[[nodiscard]] bool fitsInCell(const Math::RectangleF& bounds) const noexcept;
+
+		[[nodiscard]] std::uint32_t getBucket(std::int32_t cellX, std::int32_t cellY) const noexcept;
+		/**
+		 * @brief Add the pairs of an entry with the entries of a cell
+		 * @param entryIndex The index of the entry
+		 * @param cellX The X coordinate of the cell
+		 * @param cellY The Y coordinate of the cell
+		 * @param start The first entry of the bucket to check, to skip the entries already checked in the same cell
+		 */
+		void addPairsWithCell(std::size_t entryIndex, std::int32_t cellX, std::int32_t cellY, std::size_t start) noexcept;
+
+	public:
+		/**
+		 * @brief Sort the colliders by cell, the ones bigger than a cell are kept apart
+		 * @param colliders The enabled colliders
+		 */
+		void Update(std::span<const SimplifiedCollider> colliders) noexcept override;
+		/**
+		 * @brief Check each collider against the colliders of its cell and of the neighbour cells, and each collider bigger than a cell against all the colliders
+		 * @return All the possible pairs of colliders
+		 */
+		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept override;
+		/**
+		 * @brief Get the bounds of the cells that contain a collider
+		 * @return All the used cells
+		 */
+		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept override;
+		/**
+		 * @brief Check the colliders of the cells the bounds are on and of the cells before them, or all the colliders if the bounds cover more cells than there are buckets.
+		 * The colliders bigger than a cell are always checked
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to
+		 */
+		void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept override;
+
+		/**
+		 * @brief Set the size of the cells, used from the next update
+		 * @param cellSize The size of the cells, 0 to use twice the median size of the colliders
+		 */
+		void SetCellSize(float cellSize) noexcept;
+		/**
+		 * @brief Get the size of the cells used by the last update
+		 * @return The size of the cells
+		 */
+		[[nodiscard]] float GetCellSize() const noexcept;
+		/**
+		 * @brief Get the number of colliders in the spatial hash
+		 * @return The number of colliders
+		 */
+		[[nodiscard]] std::size_t GetCollidersCount() const noexcept;
+		/**
+		 * @brief Get the number of colliders bigger than a cell, which are checked against all the others
+		 * @return The number of big colliders
+		 */
+		[[nodiscard]] std::size_t GetLargeCollidersCount() const noexcept;
+	};
+}
\ No newline at end of file
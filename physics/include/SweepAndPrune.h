@@ -0,0 +1,101 @@
+#pragma once
+
+#include "BroadPhase.h"
+
+#include "Allocator.h"
+
+namespace Physics
+{
+	/**
+	 * @brief The interval of a collider bounds on one axis
+	 */
+	struct SweepEndpoint
+	{
+		float Min {};
+		float Max {};
+		std::size_t Proxy {};
+	};
+
+	/**
+	 * @brief A collider kept by the sweep and prune between updates
+	 */
+	struct SweepProxy
+	{
+		ColliderRef Ref {};
+		Math::RectangleF Bounds {Math::Vec2F::Zero(), Math::Vec2F::Zero()};
+		std::size_t LastUpdate {0};
+		bool InUse {false};
+	};
+
+	/**
+	 * @brief A sort and sweep broad phase. The colliders intervals are kept sorted on both axes between updates with an insertion sort,
+	 * which is close to linear when the colliders only move a little. The pairs are found by sweeping the axis where the colliders are the most spread.
+	 */
+	class SweepAndPrune final : public BroadPhase
+	{
+	public:
+		SweepAndPrune() noexcept = default;
+
+	private:
+		HeapAllocator _heapAllocator {};
+		/**
+		 * @brief The colliders, indexed by the collider index
+		 */
+		MyVector<SweepProxy> _proxies { StandardAllocator<SweepProxy> {_heapAllocator} };
+		MyVector<SweepEndpoint> _endpointsX { StandardAllocator<SweepEndpoint> {_heapAllocator} };
+		MyVector<SweepEndpoint> _endpointsY { StandardAllocator<SweepEndpoint> {_heapAllocator} };
+		MyVector<ColliderPair> _allPossiblePairs { StandardAllocator<ColliderPair> {_heapAllocator} };
+
+		/**
+		 * @brief The largest size of the intervals on each axis, the intervals that overlap a value start at most this far before it
+		 */
+		float _maxExtentX { 0.f };
+		float _maxExtentY { 0.f };
+		std::size_t _updateCount { 0 };
+		bool _sweepOnX { true };
+
+		/**
+		 * @brief Refresh the intervals of the endpoints, remove the ones of the colliders that were not updated and sort them again
+		 * @param endpoints The endpoints of one axis
+		 * @param sortedCount The number of endpoints that were sorted in the last update, the others have been added since
+		 * @param onX True if the endpoints are on the X axis
+		 * @param maxExtent The largest size of the intervals, set by the update
+		 */
+		void updateEndpoints(MyVector<SweepEndpoint>& endpoints, std::size_t sortedCount, bool onX, float& maxExtent) noexcept;
+		/**
+		 * @brief Sort the endpoints by their min value, fast when they are almost sorted
+		 * @param endpoints The endpoints to sort
+		 * @param count The number of endpoints to sort from the start
+		 */
+		static void insertionSort(MyVector<SweepEndpoint>& endpoints, std::size_t count) noexcept;
+
+	public:
+		/**
+		 * @brief Add, move and remove the colliders and sort their intervals
+		 * @param colliders The enabled colliders
+		 */
+		void Update(std::span<const SimplifiedCollider> colliders) noexcept override;
+		/**
+		 * @brief Sweep the sorted intervals to find all the pairs of colliders whose bounds overlap
+		 * @return All the possible pairs of colliders
+		 */
+		[[nodiscard]] const MyVector<ColliderPair>& GetAllPossiblePairs() noexcept override;
+		/**
+		 * @brief The sweep and prune does not split the space
+		 * @return An empty list
+		 */
+		[[nodiscard]] std::vector<Math::RectangleF> GetBoundaries() const noexcept override;
+		/**
+		 * @brief Sweep the sorted intervals from the first one that can reach the bounds, found with a binary search, until they start after the bounds
+		 * @param bounds The bounds to check
+		 * @param results The colliders to add to
+		 */
+		void Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept override;
+
+		/**
+		 * @brief Get the number of colliders in the sweep and prune
+		 * @return The number of colliders
+		 */
+		[[nodiscard]] std::size_t GetCollidersCount() const noexcept;
+	};
+}
\ No newline at end of file
@@ -4,14 +4,52 @@
 #include "Collider.h"
 #include "ColliderPair.h"
 #include "ContactListener.h"
-#include "QuadTree.h"
+#include "ContactEvents.h"
+#include "ContactResolver.h"
+#include "BroadPhase.h"
+#include "RayPacket.h"
 #include "Allocator.h"
+#include "UniquePtr.h"
+#include "ThreadPool.h"
 
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
 #include <vector>
 #include <unordered_set>
 
 namespace Physics
 {
+    /**
+     * @brief The links of a collider to the previous and next colliders of its body
+     */
+    struct ColliderLink
+    {
+        std::size_t Previous {};
+        std::size_t Next {};
+    };
+
+    /**
+     * @brief The impulse accumulated by the solver on a contact, kept to warm start the contact in the next update
+     */
+    struct PersistentContact
+    {
+        ColliderPair Pair {};
+        float NormalImpulse {};
+    };
+
+    /**
+     * @brief The first collider a bullet collider touches along its move, at a fraction of the move
+     */
+    struct TimeOfImpact
+    {
+        std::size_t BodyIndex {};
+        ColliderRef Bullet {};
+        ColliderRef Other {};
+        float Time {};
+    };
+
     /**
      * @brief The world class is the main class of the physics engine. It contains all bodies and colliders.
      */
@@ -24,40 +62,252 @@ namespace Physics
 		 */
         explicit World(std::size_t defaultBodySize = 500) noexcept;
 		~World() noexcept = default;
+		/**
+		 * @brief The containers of the world refer to its allocator, a world cannot be copied or moved. Use Clear to start again
+		 */
+		World(const World& other) = delete;
+		World(World&& other) = delete;
+		World& operator=(const World& other) = delete;
+		World& operator=(World&& other) = delete;
 
     private:
-		QuadTree _quadTree {Math::RectangleF(Math::Vec2F::Zero(), Math::Vec2F::One())};
+		UniquePtr<ThreadPool> _threadPool;
+		UniquePtr<BroadPhase> _broadPhase;
 	    HeapAllocator _heapAllocator;
+		/**
+		 * @brief The values of the bodies by field, the bodies refer to it
+		 */
+		UniquePtr<BodyStorage> _bodyStorage;
+		/**
+		 * @brief The shapes of the colliders by shape type, the colliders refer to it
+		 */
+		UniquePtr<ShapeStorage> _shapeStorage;
 
+		MyVector<SimplifiedCollider> _broadPhaseColliders;
+		/**
+		 * @brief The colliders found by the broad phase for the last query
+		 */
+		MyVector<ColliderRef> _queryCandidates;
+
+		/**
+		 * @brief The overlapping pairs of this update and of the last one, swapped at each update.
+		 * The collider with the lowest index is first and the pairs are sorted by their key to compare them in one pass
+		 */
+		MyVector<ColliderPair> _colliderPairs;
 		MyVector<ColliderPair> _lastColliderPairs;
+		/**
+		 * @brief The bodies given to the user, each one refers to its values in the body storage
+		 */
 	    MyVector<Body> _bodies;
 		MyVector<Collider> _colliders;
 	    MyVector<std::size_t> _colliderGenerations;
 	    MyVector<std::size_t> _bodyGenerations;
+		/**
+		 * @brief The indices of the free bodies and colliders, the last one is used first
+		 */
+		MyVector<std::size_t> _freeBodies;
+		MyVector<std::size_t> _freeColliders;
+		/**
+		 * @brief The first collider of each body, the colliders of a body are linked together by their links
+		 */
+		MyVector<std::size_t> _bodyColliders;
+		/**
+		 * @brief The links between the colliders of the same body, indexed by the collider index
+		 */
+		MyVector<ColliderLink> _colliderLinks;
+		/**
+		 * @brief The results of each task of the parallel stages, concatenated in order after the tasks
+		 */
+		std::vector<MyVector<SimplifiedCollider>> _taskColliders;
+		std::vector<MyVector<ColliderPair>> _taskPairs;
+		/**
+		 * @brief The pairs of circles and the pairs of a circle and a rectangle of each task, checked together in batches by the narrow phase
+		 */
+		std::vector<MyVector<ColliderPair>> _taskCirclePairs;
+		std::vector<MyVector<ColliderPair>> _taskCircleRectanglePairs;
+		/**
+		 * @brief The possible pairs with a bullet of each task and of all the tasks, checked after the bullets are moved back to their impact
+		 */
+		std::vector<MyVector<ColliderPair>> _taskBulletPairs;
+		MyVector<ColliderPair> _bulletPairs;
+		/**
+		 * @brief The colliding pairs of this update to resolve, sorted by key
+		 */
+		MyVector<ColliderPair> _contactPairs;
+		/**
+		 * @brief The parent of each body in the union-find of the islands, indexed by the body index
+		 */
+		MyVector<std::size_t> _islandParents;
+		/**
+		 * @brief The island of each root body of the union-find
+		 */
+		MyVector<std::size_t> _bodyIslands;
+		/**
+		 * @brief The resolver of each contact to resolve and the impulse it had in the last update
+		 */
+		MyVector<ContactResolver> _contactResolvers;
+		MyVector<float> _warmImpulses;
+		/**
+		 * @brief The impulses of the contacts resolved in the last update, sorted by the key of their pair
+		 */
+		MyVector<PersistentContact> _persistentContacts;
+		/**
+		 * @brief The indices of the contacts grouped by island, in the order of their key in each island, and the start of each island with the end of the last one
+		 */
+		MyVector<std::size_t> _islandContacts;
+		MyVector<std::size_t> _islandOffsets;
+		/**
+		 * @brief The impacts of the bullets found in this update, sorted by body and by time
+		 */
+		MyVector<TimeOfImpact> _timeOfImpacts;
 
         ContactListener* _contactListener { nullptr };
+		/**
+		 * @brief The events of the last call to Update or Advance, only the kinds of the event types are written
+		 */
+		ContactEvents _contactEvents;
+		ContactEventTypes _contactEventTypes {};
 
         Math::Vec2F _gravity;
+		/**
+		 * @brief A dynamic body slower than the sleep velocity during the sleep frames falls asleep
+		 */
+		float _sleepVelocity { 0.01f };
+		std::size_t _sleepFrames { 30 };
+		std::size_t _velocityIterations { 8 };
+
+		BroadPhaseType _broadPhaseType { BroadPhaseType::QuadTree };
+		std::size_t _threadCount { 1 };
+
+		float _fixedTimeStep { 1.f / 60.f };
+		std::size_t _maxFixedSteps { 8 };
+		/**
+		 * @brief The time given to Advance that is not yet simulated, less than a fixed time step
+		 */
+		float _accumulatedTime { 0.f };
+		/**
+		 * @brief The time of the running update, the move of a bullet during the update is its velocity times this time
+		 */
+		float _deltaTime { 0.f };
+
+		static constexpr std::size_t _noCollider = std::numeric_limits<std::size_t>::max();
+		static constexpr std::size_t _noIsland = std::numeric_limits<std::size_t>::max();
+		/**
+		 * @brief The number of items of each task of the parallel stages, the bodies are a multiple of the 8 bodies integrated at a time
+		 */
+		static constexpr std::size_t _bodiesPerTask = 1024;
+		static constexpr std::size_t _collidersPerTask = 256;
+		static constexpr std::size_t _pairsPerTask = 256;
+
+		/**
+		 * @brief Add bodies up to the given size, the new ones are added to the free bodies
+		 */
+		void resizeBodies(std::size_t newSize) noexcept;
+		/**
+		 * @brief Add colliders up to the given size, the new ones are added to the free colliders
+		 */
+		void resizeColliders(std::size_t newSize) noexcept;
+
+		/**
+		 * @brief Run a job on consecutive ranges of items, on the thread pool when there is one.
+		 * The ranges do not depend on the number of threads, the results are the same with any number of threads.
+		 * @param count The number of items
+		 * @param itemsPerTask The number of items of each task when the job is run on the thread pool
+		 * @param job The job to run with the index of the task and the range of items of the task
+		 * @return The number of tasks
+		 */
+		std::size_t parallelFor(std::size_t count, std::size_t itemsPerTask, const std::function<void(std::size_t, std::size_t, std::size_t)>& job) noexcept;
 
 		/**
 		 * @brief Check the collisions and triggers of the colliders
 		 */
 		void updateColliders() noexcept;
 		/**
-		 * @brief Check the collisions and triggers of the colliders in the quadtree
+		 * @brief Give the enabled colliders to the broad phase
 		 */
 		void insertColliders() noexcept;
 		/**
-		 * @brief Check the collisions and triggers of the colliders in the quadtree
+		 * @brief Fill the pairs of this update with the pairs of the broad phase whose shapes overlap, sorted by key.
+		 * The pairs of circles and of a circle and a rectangle are grouped by shapes and checked in batches, the other pairs one at a time.
+		 */
+        void findColliderPairs() noexcept;
+		/**
+		 * @brief Add a possible pair of the broad phase to the pairs to check, by the shapes of its colliders
+		 * @param colliderPair The possible pair, of colliders of different bodies
+		 * @param pairs The overlapping pairs, the pairs of rectangles are added without a check and the other pairs that are not batched are checked one at a time
+		 * @param circlePairs The pairs of circles to check in batches
+		 * @param circleRectanglePairs The pairs of a circle and a rectangle to check in batches
+		 */
+		void addPossiblePair(const ColliderPair& colliderPair, MyVector<ColliderPair>& pairs, MyVector<ColliderPair>& circlePairs, MyVector<ColliderPair>& circleRectanglePairs) const noexcept;
+		/**
+		 * @brief Keep the pairs of circles that overlap, 8 pairs at a time with AVX on their gathered centers and radii
+		 * @param circlePairs The pairs of circle colliders, with the collider with the lowest index first
+		 * @param pairs The overlapping pairs to add to
+		 */
+		void overlapCircles(const MyVector<ColliderPair>& circlePairs, MyVector<ColliderPair>& pairs) const noexcept;
+		/**
+		 * @brief Keep the pairs of a circle and a rectangle that overlap, 8 pairs at a time with AVX on their gathered shapes.
+		 * The checks are the ones of Math::Intersect, so the same pairs are kept as one at a time.
+		 * @param circleRectanglePairs The pairs with the circle collider first and the rectangle collider second
+		 * @param pairs The overlapping pairs to add to, with the collider with the lowest index first
+		 */
+		void overlapCircleRectangles(const MyVector<ColliderPair>& circleRectanglePairs, MyVector<ColliderPair>& pairs) const noexcept;
+		/**
+		 * @brief Check the collisions and triggers of the colliders in the broad phase, by merging the sorted pairs of this update and of the last one
 		 */
-        MyVector<ColliderPair> getColliderPairs() noexcept;
 		void processColliders() noexcept;
+		void onContactEnter(const ColliderPair& colliderPair) noexcept;
+		void onContactStay(const ColliderPair& colliderPair) noexcept;
+		/**
+		 * @brief Call the exit event of a pair, nothing is called if one of the colliders has been destroyed
+		 */
+		void onContactExit(const ColliderPair& colliderPair) noexcept;
+		/**
+		 * @brief Wake up the dynamic bodies of a pair, the colliders that have been destroyed are skipped
+		 */
+		void wakeUp(const ColliderPair& colliderPair) noexcept;
+		/**
+		 * @brief Check if a pair was in the overlapping pairs of the last update
+		 * @param colliderPair The pair, with the collider with the lowest index first
+		 * @return True if the pair overlapped in the last update
+		 */
+		[[nodiscard]] bool wasColliding(const ColliderPair& colliderPair) const noexcept;
+		/**
+		 * @brief Get the key of a pair whose collider with the lowest index is first
+		 * @return The index of the first collider in the high bits and the index of the second one in the low bits
+		 */
+		[[nodiscard]] static std::uint64_t getPairKey(const ColliderPair& colliderPair) noexcept;
+		/**
+		 * @brief Find the root of the island of a body, the path is halved on the way
+		 * @param bodyIndex The index of the body
+		 * @return The index of the root body of the island
+		 */
+		[[nodiscard]] std::size_t findIsland(std::size_t bodyIndex) noexcept;
+		/**
+		 * @brief Group the contacts to resolve in islands of dynamic bodies linked by contacts.
+		 * The static and kinematic bodies are not moved by the contacts, they do not link the islands.
+		 */
+		void buildIslands() noexcept;
+		/**
+		 * @brief Resolve the contacts of this update with the impulses of the last update as a start.
+		 * The islands share no moving body and are resolved in parallel.
+		 */
+		void solveIslands() noexcept;
 		/**
-		 * @brief Calculate the collisions of the colliders
-		 * @param colliderRef The collider to check the collisions for
-		 * @param otherColliderRef The other collider to check the collisions for
+		 * @brief Move the bullets back to the first collider they touch along their move of this update and resolve the contact,
+		 * the pair then overlaps and is found by the narrow phase instead of being passed through
+		 * @param colliderPairs The possible pairs of the broad phase with a bullet, found with the swept bounds of the bullets
 		 */
-		void onCollision(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept;
+		void solveTimeOfImpacts(const MyVector<ColliderPair>& colliderPairs) noexcept;
+		/**
+		 * @brief Find when a collider moving against another one starts to touch it.
+		 * Two circles are swept exactly, the other shapes are swept as the rectangle of their sizes added together, which is larger at the corners.
+		 * @param collider The moving collider, at the end of its move
+		 * @param other The collider it moves against
+		 * @param move The move of the collider relative to the other one
+		 * @return The fraction of the move at which the colliders start to touch, negative if they do not or if they already overlap at the start
+		 */
+		[[nodiscard]] static float getTimeOfImpact(const Collider& collider, const Collider& other, Math::Vec2F move) noexcept;
 		/**
 		 * @brief Check if the colliders overlap
 		 * @param colliderA	 The first collider
@@ -65,12 +315,60 @@ namespace Physics
 		 * @return True if the colliders overlap
 		 */
 		[[nodiscard]] static bool overlap(const Collider& colliderA, const Collider& colliderB) noexcept;
+		/**
+		 * @brief Check if the shape of a collider overlaps a rectangle
+		 */
+		[[nodiscard]] static bool overlap(const Collider& collider, const Math::RectangleF& rectangle) noexcept;
+		/**
+		 * @brief Check if the shape of a collider overlaps a circle, a circle with a radius of 0 checks if it contains the center
+		 */
+		[[nodiscard]] static bool overlap(const Collider& collider, const Math::CircleF& circle) noexcept;
+		/**
+		 * @brief Find the colliders whose bounds overlap the bounds of a shape with the broad phase and write the ones that are still enabled
+		 * @param bounds The bounds of the shape
+		 * @param shape The shape to check the colliders against if exact is true
+		 * @param results The buffer to write the colliders into
+		 * @param exact True to only write the colliders whose shape overlaps the shape
+		 * @return The number of colliders written
+		 */
+		template<typename Shape>
+		std::size_t query(const Math::RectangleF& bounds, const Shape& shape, std::span<ColliderRef> results, bool exact) noexcept;
 
 		/**
-		 * @brief Update the bodies
+		 * @brief Integrate the forces and velocities of all the bodies, 8 bodies at a time with AVX, then move the colliders with their body.
+		 * Both are split in tasks on the thread pool. The bodies are not branched on by type, the static, kinematic and disabled bodies have no inverse mass and the static and disabled ones no velocity.
 		 * @param deltaTime The time since the last update
 		 */
 		void updateBodies(float deltaTime) noexcept;
+		/**
+		 * @brief Integrate a range of bodies, see updateBodies
+		 * @param begin The first body, a multiple of 8
+		 * @param end The end of the range
+		 * @param deltaTime The time since the last update
+		 */
+		void integrateBodies(std::size_t begin, std::size_t end, float deltaTime) noexcept;
+		/**
+		 * @brief Move a range of colliders to the position of their body
+		 * @param begin The first collider
+		 * @param end The end of the range
+		 */
+		void syncColliders(std::size_t begin, std::size_t end) noexcept;
+		/**
+		 * @brief Put to sleep the dynamic bodies that stayed slower than the sleep velocity during the sleep frames
+		 */
+		void updateSleep() noexcept;
+		/**
+		 * @brief Check if a body does not move, a static body or a sleeping dynamic body
+		 * @param bodyIndex The index of the body
+		 * @return True if the body does not move
+		 */
+		[[nodiscard]] bool isResting(std::size_t bodyIndex) const noexcept;
+
+		/**
+		 * @brief Run one update of the world, the contact events are added to the ones of the steps before
+		 * @param deltaTime The time of the update
+		 */
+		void step(float deltaTime) noexcept;
 
     public:
 		/**
@@ -78,6 +376,30 @@ namespace Physics
 		 * @param deltaTime The time since the last update
 		 */
         void Update(float deltaTime) noexcept;
+		/**
+		 * @brief Destroy all the bodies and colliders and forget the contacts of the last update, the settings of the world are kept.
+		 * The next bodies and colliders are created in the same order as in a new world
+		 */
+		void Clear() noexcept;
+		/**
+		 * @brief Run the fixed updates that fit in the elapsed time, the time left is kept for the next call.
+		 * When more fixed updates than the max are due, the extra time is dropped to let the world catch up.
+		 * @param deltaTime The real time since the last call
+		 * @return The number of fixed updates run
+		 */
+		std::size_t Advance(float deltaTime) noexcept;
+		/**
+		 * @brief Get how far the time left by Advance is between the last fixed update and the next one
+		 * @return The interpolation factor, from 0 to 1
+		 */
+		[[nodiscard]] float GetInterpolationAlpha() const noexcept;
+		/**
+		 * @brief Get the position of a body between its position before the last update and its current one, to render it smoothly.
+		 * The interpolation factor is the one of GetInterpolationAlpha, the last update can be run by Update or by Advance
+		 * @param bodyRef The bodyRef of the body
+		 * @return The interpolated position
+		 */
+		[[nodiscard]] Math::Vec2F GetInterpolatedPosition(BodyRef bodyRef) const;
 
 		/**
 		 * @brief Create a body. Sets the bodyRef of the body. Enables the body
@@ -119,17 +441,103 @@ namespace Physics
 		 * @param contactListener The contact listener
 		 */
         void SetContactListener(ContactListener* contactListener) noexcept;
+		/**
+		 * @brief Choose the contact events written to the event buffers of the world, read with GetContactEvents after each call to Update or Advance.
+		 * The buffers are used along with the contact listener, without a virtual call per event, and the stay events can be left out
+		 * @param contactEventTypes The kinds of events to write, none by default
+		 */
+		void SetContactEventTypes(ContactEventTypes contactEventTypes) noexcept;
+		/**
+		 * @brief Get the contact events of the last call to Update or Advance
+		 * @return The events of the kinds chosen with SetContactEventTypes
+		 */
+		[[nodiscard]] const ContactEvents& GetContactEvents() const noexcept;
 
 	    /**
 		 * @brief Get all the boundaries of the quadtree
 		 * @return All the boundaries of the quadtree
 		 */
 	    [[nodiscard]] std::vector<Math::RectangleF> GetQuadTreeBoundaries() const noexcept;
+		/**
+		 * @brief Find the colliders that overlap a rectangle, with the colliders positions of the last update.
+		 * Does not allocate once the world has run a few queries.
+		 * @param rectangle The rectangle to check
+		 * @param results The buffer to write the colliders into, the colliders that do not fit in it are ignored
+		 * @param exact False to only check the bounds of the colliders, true to check their shapes
+		 * @return The number of colliders written
+		 */
+		std::size_t QueryAABB(const Math::RectangleF& rectangle, std::span<ColliderRef> results, bool exact = false) noexcept;
+		/**
+		 * @brief Find the colliders that contain a point, with the colliders positions of the last update
+		 * @param point The point to check
+		 * @param results The buffer to write the colliders into, the colliders that do not fit in it are ignored
+		 * @param exact False to only check the bounds of the colliders, true to check their shapes
+		 * @return The number of colliders written
+		 */
+		std::size_t QueryPoint(Math::Vec2F point, std::span<ColliderRef> results, bool exact = false) noexcept;
+		/**
+		 * @brief Find the colliders that overlap a circle, with the colliders positions of the last update
+		 * @param circle The circle to check
+		 * @param results The buffer to write the colliders into, the colliders that do not fit in it are ignored
+		 * @param exact False to only check the bounds of the colliders, true to check their shapes
+		 * @return The number of colliders written
+		 */
+		std::size_t QueryCircle(const Math::CircleF& circle, std::span<ColliderRef> results, bool exact = false) noexcept;
+
+		/**
+		 * @brief Cast rays against the colliders with the colliders positions of the last update. The rays are cast 4 at a time,
+		 * each packet queries the broad phase once with the bounds of its rays, so rays close to each other should be next to each other.
+		 * A ray that starts inside a collider does not hit it.
+		 * @param rays The rays to cast
+		 * @param hits The closest hit of each ray, the rays after the size of the hits are not cast
+		 * @return The number of rays that hit a collider
+		 */
+		std::size_t RayCastBatch(std::span<const Ray> rays, std::span<RayCastHit> hits) noexcept;
+
+		/**
+		 * @brief Set the broad phase used to find the possible pairs of colliders, the colliders are inserted again at the next update
+		 * @param broadPhaseType The broad phase to use
+		 * @param cellSize The size of the cells of the spatial hash, 0 to use twice the median size of the colliders. Not used by the other broad phases
+		 * @param looseness The factor applied to the size of the children of the loose quadtree, above 1. Not used by the other broad phases
+		 */
+		void SetBroadPhase(BroadPhaseType broadPhaseType, float cellSize = 0.f, float looseness = 2.f) noexcept;
+		/**
+		 * @brief Get the broad phase used to find the possible pairs of colliders
+		 * @return The broad phase type
+		 */
+		[[nodiscard]] BroadPhaseType GetBroadPhaseType() const noexcept;
+		/**
+		 * @brief Set the number of threads used by the world, the results are the same whatever the number of threads
+		 * @param threadCount The number of threads including the calling thread, 1 to only use the calling thread
+		 */
+		void SetThreadCount(std::size_t threadCount) noexcept;
+		/**
+		 * @brief Get the number of threads used by the world
+		 * @return The number of threads including the calling thread
+		 */
+		[[nodiscard]] std::size_t GetThreadCount() const noexcept;
 
 		/**
 		 * @brief Get the gravity of the world
 		 * @param gravity The gravity of the world
 		 */
         void SetGravity(Math::Vec2F gravity) noexcept;
+		/**
+		 * @brief Set when the dynamic bodies fall asleep, a sleeping body is not integrated and its contacts with resting bodies are not checked
+		 * @param velocity The velocity under which a body can sleep, 0 to never put the bodies to sleep
+		 * @param frames The number of updates the body must stay under the velocity before sleeping
+		 */
+		void SetSleepThreshold(float velocity, std::size_t frames) noexcept;
+		/**
+		 * @brief Set the number of times the velocity of each contact is solved per update
+		 * @param iterations The number of iterations, at least 1
+		 */
+		void SetVelocityIterations(std::size_t iterations) noexcept;
+		/**
+		 * @brief Set the fixed updates run by Advance
+		 * @param timeStep The time of each fixed update, more than 0
+		 * @param maxSteps The max number of fixed updates per call to Advance, at least 1
+		 */
+		void SetFixedTimeStep(float timeStep, std::size_t maxSteps) noexcept;
     };
 }
\ No newline at end of file
@@ -8,116 +8,258 @@ namespace Physics
 		_velocity = velocity;
 	}
 
+	Body::Body(BodyStorage* storage, std::size_t index) noexcept : _storage(storage), _index(index) {}
+
 	[[nodiscard]] Math::Vec2F Body::Position() const noexcept
 	{
-		return _position;
+		if (_storage == nullptr) return _position;
+
+		return { _storage->PositionsX[_index], _storage->PositionsY[_index] };
 	}
 
 	void Body::SetPosition(Math::Vec2F position) noexcept
 	{
-		_position = position;
+		WakeUp();
+
+		if (_storage == nullptr)
+		{
+			_position = position;
+			return;
+		}
+
+		_storage->PositionsX[_index] = position.X;
+		_storage->PositionsY[_index] = position.Y;
+		_storage->PreviousPositionsX[_index] = position.X;
+		_storage->PreviousPositionsY[_index] = position.Y;
+		_storage->Changed[_index] = 1;
 	}
 
 	[[nodiscard]] Math::Vec2F Body::Velocity() const noexcept
 	{
-		return _velocity;
+		if (_storage == nullptr) return _velocity;
+
+		return { _storage->VelocitiesX[_index], _storage->VelocitiesY[_index] };
 	}
 
 	void Body::SetVelocity(Math::Vec2F velocity) noexcept
 	{
-        if (_bodyType == BodyType::Static) return;
+        if (GetBodyType() == BodyType::Static) return;
 
-		_velocity = velocity;
+		WakeUp();
+
+		if (_storage == nullptr)
+		{
+			_velocity = velocity;
+			return;
+		}
+
+		_storage->VelocitiesX[_index] = velocity.X;
+		_storage->VelocitiesY[_index] = velocity.Y;
 	}
 
 	[[nodiscard]] Math::Vec2F Body::Force() const noexcept
 	{
-		return _force;
+		if (_storage == nullptr) return _force;
+
+		return { _storage->ForcesX[_index], _storage->ForcesY[_index] };
 	}
 
 	void Body::SetForce(Math::Vec2F force) noexcept
 	{
-		_force = force;
+		WakeUp();
+
+		if (_storage == nullptr)
+		{
+			_force = force;
+			return;
+		}
+
+		_storage->ForcesX[_index] = force.X;
+		_storage->ForcesY[_index] = force.Y;
 	}
 
 	[[nodiscard]] float Body::Mass() const noexcept
 	{
-		return _mass;
+		return _storage == nullptr ? _mass : _storage->Masses[_index];
 	}
 
 	[[nodiscard]] float Body::InverseMass() const noexcept
 	{
-		return _inverseMass;
+		return _storage == nullptr ? _inverseMass : _storage->InverseMasses[_index];
 	}
 
 	void Body::SetMass(float mass) noexcept
 	{
-		if (mass <= 0.f || _bodyType != BodyType::Dynamic) return;
+		if (mass <= 0.f || GetBodyType() != BodyType::Dynamic) return;
 
-		_mass = mass;
-		_inverseMass = 1.f / mass;
+		if (_storage == nullptr)
+		{
+			_mass = mass;
+			_inverseMass = 1.f / mass;
+			return;
+		}
+
+		_storage->Masses[_index] = mass;
+		_storage->InverseMasses[_index] = 1.f / mass;
 	}
 
     [[nodiscard]] BodyType Body::GetBodyType() const noexcept
     {
-        return _bodyType;
+        return _storage == nullptr ? _bodyType : _storage->Types[_index];
     }
 
     void Body::SetBodyType(BodyType bodyType) noexcept
     {
-        _bodyType = bodyType;
+        if (_storage == nullptr)
+        {
+            _bodyType = bodyType;
+        }
+        else
+        {
+            _storage->Types[_index] = bodyType;
+        }
 
         if (bodyType == BodyType::Dynamic) return;
 
-	    _mass = 0.f;
-	    _inverseMass = 0.f;
-	    _velocity = Math::Vec2F::Zero();
+        if (_storage == nullptr)
+        {
+            _mass = 0.f;
+            _inverseMass = 0.f;
+            _velocity = Math::Vec2F::Zero();
+            return;
+        }
+
+        _storage->Masses[_index] = 0.f;
+        _storage->InverseMasses[_index] = 0.f;
+        _storage->VelocitiesX[_index] = 0.f;
+        _storage->VelocitiesY[_index] = 0.f;
     }
 
     [[nodiscard]] bool Body::UseGravity() const noexcept
     {
-        return _useGravity;
+        return _storage == nullptr ? _useGravity : _storage->GravityScales[_index] != 0.f;
+    }
+
+    [[nodiscard]] bool Body::IsAwake() const noexcept
+    {
+        return _storage == nullptr ? _awake : _storage->AwakeScales[_index] != 0.f;
+    }
+
+    [[nodiscard]] bool Body::IsBullet() const noexcept
+    {
+        return _storage == nullptr ? _isBullet : _storage->Bullets[_index] != 0;
+    }
+
+    void Body::SetBullet(bool isBullet) noexcept
+    {
+        if (_storage == nullptr)
+        {
+            _isBullet = isBullet;
+            return;
+        }
+
+        if ((_storage->Bullets[_index] != 0) == isBullet) return;
+
+        _storage->Bullets[_index] = isBullet ? 1 : 0;
+
+        if (isBullet)
+        {
+            _storage->BulletCount++;
+        }
+        else
+        {
+            _storage->BulletCount--;
+        }
+    }
+
+    void Body::WakeUp() noexcept
+    {
+        if (_storage == nullptr)
+        {
+            _awake = true;
+            return;
+        }
+
+        // An awake body keeps counting its slow updates, the contacts that push it every update do not keep it awake
+        if (_storage->AwakeScales[_index] != 0.f) return;
+
+        _storage->AwakeScales[_index] = 1.f;
+        _storage->SleepFrames[_index] = 0;
     }
 
     void Body::SetUseGravity(bool useGravity) noexcept
     {
-        _useGravity = useGravity;
+        if (_storage == nullptr)
+        {
+            _useGravity = useGravity;
+            return;
+        }
+
+        _storage->GravityScales[_index] = useGravity ? 1.f : 0.f;
     }
 
 	void Body::AddForce(Math::Vec2F force) noexcept
 	{
-		_force += force;
+		SetForce(Force() + force);
 	}
 
     void Body::AddVelocity(Math::Vec2F velocity) noexcept
     {
-        _velocity += velocity;
+        SetVelocity(Velocity() + velocity);
     }
 
     void Body::AddPosition(Math::Vec2F position) noexcept
     {
-        _position += position;
+        WakeUp();
+
+        if (_storage == nullptr)
+        {
+            _position += position;
+            return;
+        }
+
+        // The body moves from its last position, it is still interpolated
+        _storage->PositionsX[_index] += position.X;
+        _storage->PositionsY[_index] += position.Y;
+        _storage->Changed[_index] = 1;
     }
 
 	void Body::Disable() noexcept
 	{
-		_mass = -1.f;
+		SetBullet(false);
+		SetPosition(Math::Vec2F(0, 0));
+		SetForce(Math::Vec2F(0, 0));
+		SetBodyType(BodyType::Dynamic);
 
-		_position = Math::Vec2F(0, 0);
-		_velocity = Math::Vec2F(0, 0);
-		_force = Math::Vec2F(0, 0);
-		_inverseMass = 0.f;
-        _bodyType = BodyType::Dynamic;
+		if (_storage == nullptr)
+		{
+			_mass = -1.f;
+			_inverseMass = 0.f;
+			_velocity = Math::Vec2F(0, 0);
+			return;
+		}
+
+		_storage->Masses[_index] = -1.f;
+		_storage->InverseMasses[_index] = 0.f;
+		_storage->VelocitiesX[_index] = 0.f;
+		_storage->VelocitiesY[_index] = 0.f;
 	}
 
 	void Body::Enable() noexcept
 	{
-		_mass = 1.f;
-		_inverseMass = 1.f;
+		if (_storage == nullptr)
+		{
+			_mass = 1.f;
+			_inverseMass = 1.f;
+			return;
+		}
+
+		_storage->Masses[_index] = 1.f;
+		_storage->InverseMasses[_index] = 1.f;
 	}
 
 	[[nodiscard]] bool Body::IsEnabled() const noexcept
 	{
-		return _mass >= 0.f;
+		return Mass() >= 0.f;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "BodyStorage.h"
+
+namespace Physics
+{
+	BodyStorage::BodyStorage(HeapAllocator& allocator) noexcept :
+		PositionsX {StandardAllocator<float> {allocator}},
+		PositionsY {StandardAllocator<float> {allocator}},
+		PreviousPositionsX {StandardAllocator<float> {allocator}},
+		PreviousPositionsY {StandardAllocator<float> {allocator}},
+		VelocitiesX {StandardAllocator<float> {allocator}},
+		VelocitiesY {StandardAllocator<float> {allocator}},
+		ForcesX {StandardAllocator<float> {allocator}},
+		ForcesY {StandardAllocator<float> {allocator}},
+		Masses {StandardAllocator<float> {allocator}},
+		InverseMasses {StandardAllocator<float> {allocator}},
+		GravityScales {StandardAllocator<float> {allocator}},
+		AwakeScales {StandardAllocator<float> {allocator}},
+		SleepFrames {StandardAllocator<std::size_t> {allocator}},
+		Changed {StandardAllocator<std::uint8_t> {allocator}},
+		Bullets {StandardAllocator<std::uint8_t> {allocator}},
+		Types {StandardAllocator<BodyType> {allocator}} {}
+
+	void BodyStorage::Resize(std::size_t size) noexcept
+	{
+		PositionsX.resize(size, 0.f);
+		PositionsY.resize(size, 0.f);
+		PreviousPositionsX.resize(size, 0.f);
+		PreviousPositionsY.resize(size, 0.f);
+		VelocitiesX.resize(size, 0.f);
+		VelocitiesY.resize(size, 0.f);
+		ForcesX.resize(size, 0.f);
+		ForcesY.resize(size, 0.f);
+		Masses.resize(size, -1.f);
+		InverseMasses.resize(size, 0.f);
+		GravityScales.resize(size, 0.f);
+		AwakeScales.resize(size, 1.f);
+		SleepFrames.resize(size, 0);
+		Changed.resize(size, 0);
+		Bullets.resize(size, 0);
+		Types.resize(size, BodyType::Dynamic);
+	}
+}
\ No newline at end of file
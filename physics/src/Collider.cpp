@@ -1,7 +1,11 @@
 #include "Collider.h"
 
+#include <utility>
+
 namespace Physics
 {
+	Collider::Collider(ShapeStorage* shapeStorage) noexcept : _shapeStorage(shapeStorage) {}
+
 	BodyRef Collider::GetBodyRef() const noexcept
 	{
 		return _bodyRef;
@@ -60,6 +64,8 @@ namespace Physics
 	void Collider::SetPosition(Math::Vec2F position) noexcept
 	{
 		_position = position;
+
+		updateWorldShape();
 	}
 
 	void Collider::SetBounciness(float bounciness) noexcept
@@ -74,25 +80,35 @@ namespace Physics
 
 	void Collider::SetCircle(Math::CircleF circle) noexcept
 	{
-		_shapeType = Math::ShapeType::Circle;
-		_shape = circle;
+		if (!setShapeType(Math::ShapeType::Circle)) return;
+
+		_shapeStorage->Circles[_shapeIndex] = circle;
         _bounds = getBounds();
+
+        updateWorldShape();
 	}
 
 	void Collider::SetRectangle(Math::RectangleF rectangle) noexcept
 	{
-		_shapeType = Math::ShapeType::Rectangle;
-		_shape = rectangle;
+		if (!setShapeType(Math::ShapeType::Rectangle)) return;
+
+		_shapeStorage->Rectangles[_shapeIndex] = rectangle;
 
         _bounds = getBounds();
+
+        updateWorldShape();
 	}
 
 	void Collider::SetPolygon(Math::PolygonF polygon) noexcept
 	{
-		_shapeType = Math::ShapeType::Polygon;
-		_shape = polygon;
+		if (!setShapeType(Math::ShapeType::Polygon)) return;
+
+		_shapeStorage->WorldPolygons[_shapeIndex] = polygon;
+		_shapeStorage->Polygons[_shapeIndex] = std::move(polygon);
 
         _bounds = getBounds();
+
+        updateWorldShape();
 	}
 
 	void Collider::Enable() noexcept
@@ -110,22 +126,83 @@ namespace Physics
 		_isEnabled = false;
 		_bounciness = 0.f;
 		_isTrigger = false;
+
+		if (_shapeStorage != nullptr)
+		{
+			_shapeStorage->Free(_shapeType, _shapeIndex);
+		}
+
 		_shapeType = Math::ShapeType::None;
 	}
 
 	Math::CircleF Collider::GetCircle() const noexcept
 	{
-	    return std::get<Math::CircleF>(_shape);
+	    return _shapeStorage->Circles[_shapeIndex];
 	}
 
 	Math::RectangleF Collider::GetRectangle() const noexcept
 	{
-		return std::get<Math::RectangleF>(_shape);
+		return _shapeStorage->Rectangles[_shapeIndex];
+	}
+
+	const Math::PolygonF& Collider::GetPolygon() const noexcept
+	{
+        return _shapeStorage->Polygons[_shapeIndex];
+	}
+
+	const Math::CircleF& Collider::GetWorldCircle() const noexcept
+	{
+		return _shapeStorage->WorldCircles[_shapeIndex];
+	}
+
+	const Math::RectangleF& Collider::GetWorldRectangle() const noexcept
+	{
+		return _shapeStorage->WorldRectangles[_shapeIndex];
 	}
 
-	Math::PolygonF Collider::GetPolygon() const noexcept
+	const Math::PolygonF& Collider::GetWorldPolygon() const noexcept
 	{
-        return std::get<Math::PolygonF>(_shape);
+		return _shapeStorage->WorldPolygons[_shapeIndex];
+	}
+
+	bool Collider::setShapeType(Math::ShapeType type) noexcept
+	{
+		if (_shapeStorage == nullptr) return false;
+
+		if (_shapeType != type)
+		{
+			_shapeStorage->Free(_shapeType, _shapeIndex);
+			_shapeIndex = _shapeStorage->Allocate(type);
+			_shapeType = type;
+		}
+
+		return true;
+	}
+
+	void Collider::updateWorldShape() noexcept
+	{
+		switch (_shapeType)
+		{
+			case Math::ShapeType::Circle:
+			{
+				const auto circle = GetCircle();
+
+				_shapeStorage->WorldCircles[_shapeIndex] = Math::CircleF(_position + circle.Center(), circle.Radius());
+				break;
+			}
+			case Math::ShapeType::Rectangle:
+			{
+				_shapeStorage->WorldRectangles[_shapeIndex] = GetRectangle() + _position;
+				break;
+			}
+			case Math::ShapeType::Polygon:
+			{
+				// The world polygon is a copy of the polygon set, only its vertices are moved
+				_shapeStorage->WorldPolygons[_shapeIndex].SetTranslated(GetPolygon(), _position);
+				break;
+			}
+			case Math::ShapeType::None: break;
+		}
 	}
 
 	Math::ShapeType Collider::GetShapeType() const noexcept
@@ -153,9 +230,7 @@ namespace Physics
 				float minY = std::numeric_limits<float>::max();
 				float maxX = std::numeric_limits<float>::min();
 				float maxY = std::numeric_limits<float>::min();
-				Math::PolygonF polygon = GetPolygon();
-
-				for (auto& vertex : polygon.Vertices())
+				for (const auto& vertex : GetPolygon().Vertices())
 				{
 					minX = std::min(minX, vertex.X);
 					minY = std::min(minY, vertex.Y);
@@ -0,0 +1,22 @@
+#include "ContactEvents.h"
+
+namespace Physics
+{
+	ContactEvents::ContactEvents(HeapAllocator& allocator) noexcept :
+		TriggerEnters {StandardAllocator<ColliderPair> {allocator}},
+		TriggerStays {StandardAllocator<ColliderPair> {allocator}},
+		TriggerExits {StandardAllocator<ColliderPair> {allocator}},
+		CollisionEnters {StandardAllocator<ColliderPair> {allocator}},
+		CollisionStays {StandardAllocator<ColliderPair> {allocator}},
+		CollisionExits {StandardAllocator<ColliderPair> {allocator}} {}
+
+	void ContactEvents::Clear() noexcept
+	{
+		TriggerEnters.clear();
+		TriggerStays.clear();
+		TriggerExits.clear();
+		CollisionEnters.clear();
+		CollisionStays.clear();
+		CollisionExits.clear();
+	}
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "ContactResolver.h"
 
+#include <algorithm>
+
 namespace Physics
 {
 	ContactResolver::ContactResolver(Body* bodyA, Body* bodyB, Collider* colliderA, Collider* colliderB) noexcept
@@ -8,10 +10,23 @@ namespace Physics
 
 	void ContactResolver::ResolveContact() noexcept
 	{
-		if (_colliderA->GetShapeType() == Math::ShapeType::Polygon || _colliderB->GetShapeType() == Math::ShapeType::Polygon) return;
+		PrepareContact(0.f);
+		SolveVelocity();
+		SolvePosition();
+	}
+
+	void ContactResolver::PrepareContact(float warmImpulse) noexcept
+	{
+		_normalImpulse = 0.f;
+		_targetVelocity = 0.f;
+		_isActive = _colliderA->GetShapeType() != Math::ShapeType::None && _colliderB->GetShapeType() != Math::ShapeType::None;
+
+		if (!_isActive) return;
 
 		setupContact();
 
+		if (!_isActive) return;
+
 		if (_bodyA->GetBodyType() == BodyType::Static || _bodyA->GetBodyType() == BodyType::Kinematic)
 		{
 			std::swap(_bodyA, _bodyB);
@@ -20,12 +35,30 @@ namespace Physics
 			_normal = -_normal;
 		}
 
-		resolveCollision();
-		resolvePosition();
+		// The bounce is taken from the velocity before any impulse of this update
+		const auto separatingVelocity = (_bodyA->Velocity() - _bodyB->Velocity()).Dot(_normal);
+
+		if (separatingVelocity < 0.f)
+		{
+			const auto massA = _bodyA->Mass();
+			const auto massB = _bodyB->Mass();
+			const auto combinedRestitution = (massA * _colliderA->GetRestitution() + massB * _colliderB->GetRestitution()) / (massA + massB);
+
+			_targetVelocity = -separatingVelocity * combinedRestitution;
+		}
+
+		applyImpulse(warmImpulse);
+		_normalImpulse = warmImpulse;
 	}
 
 	void ContactResolver::setupContact() noexcept
 	{
+		if (_colliderA->GetShapeType() == Math::ShapeType::Polygon || _colliderB->GetShapeType() == Math::ShapeType::Polygon)
+		{
+			resolvePolygonContact();
+			return;
+		}
+
 		switch (_colliderA->GetShapeType())
 		{
 			case Math::ShapeType::Circle:
@@ -58,68 +91,76 @@ namespace Physics
 		}
 	}
 
-	void ContactResolver::resolveCollision() noexcept
+	void ContactResolver::SolveVelocity() noexcept
 	{
-		const auto& separatingVelocity = (_bodyA->Velocity() - _bodyB->Velocity()).Dot(_normal);
+		if (!_isActive) return;
+
+		const auto totalInverseMass = _bodyA->InverseMass() + _bodyB->InverseMass();
+
+		if (totalInverseMass <= 0.f) return;
+
+		const auto separatingVelocity = (_bodyA->Velocity() - _bodyB->Velocity()).Dot(_normal);
+		const auto impulse = (_targetVelocity - separatingVelocity) / totalInverseMass;
+		const auto normalImpulse = std::max(_normalImpulse + impulse, 0.f);
+
+		applyImpulse(normalImpulse - _normalImpulse);
+		_normalImpulse = normalImpulse;
+	}
+
+	void ContactResolver::SolvePosition() noexcept
+	{
+		if (!_isActive) return;
+
 		const auto& inverseMassA = _bodyA->InverseMass();
 		const auto& inverseMassB = _bodyB->InverseMass();
 		const auto& totalInverseMass = inverseMassA + inverseMassB;
 
-		if (separatingVelocity > 0.0f) return;
-
-		const auto& massA = _bodyA->Mass();
-		const auto& massB = _bodyB->Mass();
-		const auto& restitutionA = _colliderA->GetRestitution();
-		const auto& restitutionB = _colliderB->GetRestitution();
-
-		const auto& combinedRestitution = (massA * restitutionA + massB * restitutionB) / (massA + massB);
-		const auto& finalSeparatingVelocity = -separatingVelocity * combinedRestitution;
-		const auto& deltaVelocity = finalSeparatingVelocity - separatingVelocity;
+		if (totalInverseMass <= 0.0f) return;
+		if (_penetration <= 0.0f) return;
 
-		const auto& impulse = deltaVelocity / totalInverseMass;
-		const auto& impulsePerMass = impulse * _normal;
+		const auto& movePerMass = _normal * (_penetration / totalInverseMass);
 
 		if (_bodyA->GetBodyType() == BodyType::Dynamic)
 		{
-			_bodyA->AddVelocity(impulsePerMass * inverseMassA);
+			_bodyA->AddPosition(movePerMass * inverseMassA);
 		}
 
 		if (_bodyB->GetBodyType() == BodyType::Dynamic)
 		{
-			_bodyB->AddVelocity(impulsePerMass * -inverseMassB);
+			_bodyB->AddPosition(movePerMass * -inverseMassB);
 		}
 	}
 
-	void ContactResolver::resolvePosition() noexcept
+	float ContactResolver::GetNormalImpulse() const noexcept
 	{
-		const auto& inverseMassA = _bodyA->InverseMass();
-		const auto& inverseMassB = _bodyB->InverseMass();
-		const auto& totalInverseMass = inverseMassA + inverseMassB;
+		return _normalImpulse;
+	}
 
-		if (totalInverseMass <= 0.0f) return;
-		if (_penetration <= 0.0f) return;
+	void ContactResolver::applyImpulse(float impulse) noexcept
+	{
+		if (impulse == 0.f) return;
 
-		const auto& movePerMass = _normal * (_penetration / totalInverseMass);
+		const auto impulsePerMass = impulse * _normal;
 
 		if (_bodyA->GetBodyType() == BodyType::Dynamic)
 		{
-			_bodyA->AddPosition(movePerMass * inverseMassA);
+			_bodyA->AddVelocity(impulsePerMass * _bodyA->InverseMass());
 		}
 
 		if (_bodyB->GetBodyType() == BodyType::Dynamic)
 		{
-			_bodyB->AddPosition(movePerMass * -inverseMassB);
+			_bodyB->AddVelocity(impulsePerMass * -_bodyB->InverseMass());
 		}
 	}
 
 	void ContactResolver::resolveCircleToCircle() noexcept
 	{
-		const auto& circleA = _colliderA->GetCircle();
-		const auto& circleB = _colliderB->GetCircle();
+		const auto& circleA = _colliderA->GetWorldCircle();
+		const auto& circleB = _colliderB->GetWorldCircle();
 		const auto& radiusA = circleA.Radius();
 		const auto& radiusB = circleB.Radius();
-		const auto& positionA = _bodyA->Position() + circleA.Center() + _colliderA->GetOffset();
-		const auto& positionB = _bodyB->Position() + circleB.Center() + _colliderB->GetOffset();
+		const auto& positionA = circleA.Center();
+		const auto& positionB = circleB.Center();
 
 		const auto& delta = positionA - positionB;
 
@@ -129,10 +170,10 @@ namespace Physics
 
 	void ContactResolver::resolveRectangleToRectangle() noexcept
 	{
-		const auto& rectangleA = _colliderA->GetRectangle();
-		const auto& rectangleB = _colliderB->GetRectangle();
-		const auto& positionA = _bodyA->Position() + rectangleA.Center() + _colliderA->GetOffset();
-		const auto& positionB = _bodyB->Position() + rectangleB.Center() + _colliderB->GetOffset();
+		const auto& rectangleA = _colliderA->GetWorldRectangle();
+		const auto& rectangleB = _colliderB->GetWorldRectangle();
+		const auto& positionA = rectangleA.Center();
+		const auto& positionB = rectangleB.Center();
 
 		const auto& delta = positionA - positionB;
 
@@ -156,10 +197,10 @@ namespace Physics
 
 	void ContactResolver::resolveCircleToRectangle() noexcept
 	{
-		const auto& circle = _colliderA->GetCircle();
-		const auto& rectangle = _colliderB->GetRectangle();
-		const auto& circleCenter = _bodyA->Position() + circle.Center() + _colliderA->GetOffset();
-		const auto& rectCenter = _bodyB->Position() + rectangle.Center() + _colliderB->GetOffset();
+		const auto& circle = _colliderA->GetWorldCircle();
+		const auto& rectangle = _colliderB->GetWorldRectangle();
+		const auto& circleCenter = circle.Center();
+		const auto& rectCenter = rectangle.Center();
 
 		const auto& delta = circleCenter - rectCenter;
 		const auto& radius = circle.Radius();
@@ -182,4 +223,35 @@ namespace Physics
 		_normal = circleToRect.Normalized();
 		_penetration = radius - distance;
 	}
+
+	void ContactResolver::resolvePolygonContact() noexcept
+	{
+		Math::ContactManifold<float> manifold;
+		bool touching = false;
+
+		switch (_colliderA->GetShapeType())
+		{
+			case Math::ShapeType::Polygon:
+			{
+				const auto& polygonA = _colliderA->GetWorldPolygon();
+
+				switch (_colliderB->GetShapeType())
+				{
+					case Math::ShapeType::Circle: touching = Math::FindContact(polygonA, _colliderB->GetWorldCircle(), manifold); break;
+					case Math::ShapeType::Rectangle: touching = Math::FindContact(polygonA, _colliderB->GetWorldRectangle(), manifold); break;
+					case Math::ShapeType::Polygon: touching = Math::FindContact(polygonA, _colliderB->GetWorldPolygon(), manifold); break;
+					case Math::ShapeType::None: break;
+				}
+			}
+			break;
+			case Math::ShapeType::Circle: touching = Math::FindContact(_colliderA->GetWorldCircle(), _colliderB->GetWorldPolygon(), manifold); break;
+			case Math::ShapeType::Rectangle: touching = Math::FindContact(_colliderA->GetWorldRectangle(), _colliderB->GetWorldPolygon(), manifold); break;
+			case Math::ShapeType::None: break;
+		}
+
+		// The shapes may not overlap when the broad bounds did, there is no contact to resolve
+		_isActive = touching;
+		_normal = manifold.Normal;
+		_penetration = manifold.Penetration;
+	}
 }
\ No newline at end of file
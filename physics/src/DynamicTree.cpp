@@ -0,0 +1,494 @@
+#include "DynamicTree.h"
+
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Physics
+{
+	DynamicTree::DynamicTree() noexcept : _root(_nullNode), _freeList(_nullNode) {}
+
+	std::size_t DynamicTree::allocateNode() noexcept
+	{
+		if (_freeList == _nullNode)
+		{
+			_nodes.emplace_back();
+			_freeList = _nodes.size() - 1;
+			_nodes[_freeList].Parent = _nullNode;
+		}
+
+		const auto index = _freeList;
+		auto& node = _nodes[index];
+
+		_freeList = node.Parent;
+
+		node.Parent = _nullNode;
+		node.Child1 = _nullNode;
+		node.Child2 = _nullNode;
+		node.Height = 0;
+
+		return index;
+	}
+
+	void DynamicTree::freeNode(std::size_t index) noexcept
+	{
+		_nodes[index].Parent = _freeList;
+		_nodes[index].Height = -1;
+		_freeList = index;
+	}
+
+	bool DynamicTree::isLeaf(std::size_t index) const noexcept
+	{
+		return _nodes[index].Child1 == _nullNode;
+	}
+
+	Math::RectangleF DynamicTree::fatten(const Math::RectangleF& bounds, Math::Vec2F displacement) noexcept
+	{
+		const auto margin = bounds.Size() * _sizeMargin;
+		const auto movement = displacement * _displacementMultiplier;
+		auto min = bounds.MinBound() - margin;
+		auto max = bounds.MaxBound() + margin;
+
+		if (movement.X < 0.f) min.X += movement.X;
+		else max.X += movement.X;
+
+		if (movement.Y < 0.f) min.Y += movement.Y;
+		else max.Y += movement.Y;
+
+		return {min, max};
+	}
+
+	Math::RectangleF DynamicTree::combine(const Math::RectangleF& a, const Math::RectangleF& b) noexcept
+	{
+		return {
+			Math::Vec2F(std::min(a.MinBound().X, b.MinBound().X), std::min(a.MinBound().Y, b.MinBound().Y)),
+			Math::Vec2F(std::max(a.MaxBound().X, b.MaxBound().X), std::max(a.MaxBound().Y, b.MaxBound().Y))
+		};
+	}
+
+	float DynamicTree::perimeter(const Math::RectangleF& bounds) noexcept
+	{
+		return 2.f * (bounds.Width() + bounds.Height());
+	}
+
+	void DynamicTree::insertLeaf(std::size_t leaf) noexcept
+	{
+		if (_root == _nullNode)
+		{
+			_root = leaf;
+			_nodes[leaf].Parent = _nullNode;
+			return;
+		}
+
+		// Find the best sibling, the one that increases the perimeter of the tree the least
+		const auto leafBounds = _nodes[leaf].Bounds;
+		std::size_t index = _root;
+
+		while (!isLeaf(index))
+		{
+			const auto& node = _nodes[index];
+			const auto perimeterNode = perimeter(node.Bounds);
+			const auto combinedPerimeter = perimeter(combine(node.Bounds, leafBounds));
+
+			// Cost of creating a new parent for this node and the new leaf
+			const auto cost = 2.f * combinedPerimeter;
+			// Minimum cost of pushing the leaf further down the tree
+			const auto inheritanceCost = 2.f * (combinedPerimeter - perimeterNode);
+
+			const auto childCost = [this, &leafBounds, inheritanceCost](std::size_t child) {
+				const auto& childBounds = _nodes[child].Bounds;
+				const auto childCombinedPerimeter = perimeter(combine(leafBounds, childBounds));
+
+				if (isLeaf(child)) return childCombinedPerimeter + inheritanceCost;
+
+				return childCombinedPerimeter - perimeter(childBounds) + inheritanceCost;
+			};
+
+			const auto cost1 = childCost(node.Child1);
+			const auto cost2 = childCost(node.Child2);
+
+			if (cost < cost1 && cost < cost2) break;
+
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		const auto sibling = index;
+		const auto oldParent = _nodes[sibling].Parent;
+		const auto newParent = allocateNode();
+
+		_nodes[newParent].Parent = oldParent;
+		_nodes[newParent].Bounds = combine(leafBounds, _nodes[sibling].Bounds);
+		_nodes[newParent].Height = _nodes[sibling].Height + 1;
+		_nodes[newParent].Child1 = sibling;
+		_nodes[newParent].Child2 = leaf;
+		_nodes[sibling].Parent = newParent;
+		_nodes[leaf].Parent = newParent;
+
+		if (oldParent == _nullNode)
+		{
+			_root = newParent;
+		}
+		else if (_nodes[oldParent].Child1 == sibling)
+		{
+			_nodes[oldParent].Child1 = newParent;
+		}
+		else
+		{
+			_nodes[oldParent].Child2 = newParent;
+		}
+
+		fixUpwards(_nodes[leaf].Parent);
+	}
+
+	void DynamicTree::removeLeaf(std::size_t leaf) noexcept
+	{
+		if (leaf == _root)
+		{
+			_root = _nullNode;
+			return;
+		}
+
+		const auto parent = _nodes[leaf].Parent;
+		const auto grandParent = _nodes[parent].Parent;
+		const auto sibling = _nodes[parent].Child1 == leaf ? _nodes[parent].Child2 : _nodes[parent].Child1;
+
+		freeNode(parent);
+
+		if (grandParent == _nullNode)
+		{
+			_root = sibling;
+			_nodes[sibling].Parent = _nullNode;
+			return;
+		}
+
+		// Replace the parent by the sibling
+		if (_nodes[grandParent].Child1 == parent)
+		{
+			_nodes[grandParent].Child1 = sibling;
+		}
+		else
+		{
+			_nodes[grandParent].Child2 = sibling;
+		}
+
+		_nodes[sibling].Parent = grandParent;
+
+		fixUpwards(grandParent);
+	}
+
+	void DynamicTree::fixUpwards(std::size_t index) noexcept
+	{
+		while (index != _nullNode)
+		{
+			index = balance(index);
+
+			auto& node = _nodes[index];
+			const auto& child1 = _nodes[node.Child1];
+			const auto& child2 = _nodes[node.Child2];
+
+			node.Height = 1 + std::max(child1.Height, child2.Height);
+			node.Bounds = combine(child1.Bounds, child2.Bounds);
+
+			index = node.Parent;
+		}
+	}
+
+	std::size_t DynamicTree::balance(std::size_t indexA) noexcept
+	{
+		auto& a = _nodes[indexA];
+
+		if (isLeaf(indexA) || a.Height < 2) return indexA;
+
+		const auto indexB = a.Child1;
+		const auto indexC = a.Child2;
+		auto& b = _nodes[indexB];
+		auto& c = _nodes[indexC];
+
+		const auto balance = c.Height - b.Height;
+
+		// Rotate C up
+		if (balance > 1)
+		{
+			const auto indexF = c.Child1;
+			const auto indexG = c.Child2;
+			auto& f = _nodes[indexF];
+			auto& g = _nodes[indexG];
+
+			c.Child1 = indexA;
+			c.Parent = a.Parent;
+			a.Parent = indexC;
+
+			if (c.Parent == _nullNode)
+			{
+				_root = indexC;
+			}
+			else if (_nodes[c.Parent].Child1 == indexA)
+			{
+				_nodes[c.Parent].Child1 = indexC;
+			}
+			else
+			{
+				_nodes[c.Parent].Child2 = indexC;
+			}
+
+			if (f.Height > g.Height)
+			{
+				c.Child2 = indexF;
+				a.Child2 = indexG;
+				g.Parent = indexA;
+				a.Bounds = combine(b.Bounds, g.Bounds);
+				c.Bounds = combine(a.Bounds, f.Bounds);
+				a.Height = 1 + std::max(b.Height, g.Height);
+				c.Height = 1 + std::max(a.Height, f.Height);
+			}
+			else
+			{
+				c.Child2 = indexG;
+				a.Child2 = indexF;
+				f.Parent = indexA;
+				a.Bounds = combine(b.Bounds, f.Bounds);
+				c.Bounds = combine(a.Bounds, g.Bounds);
+				a.Height = 1 + std::max(b.Height, f.Height);
+				c.Height = 1 + std::max(a.Height, g.Height);
+			}
+
+			return indexC;
+		}
+
+		// Rotate B up
+		if (balance < -1)
+		{
+			const auto indexD = b.Child1;
+			const auto indexE = b.Child2;
+			auto& d = _nodes[indexD];
+			auto& e = _nodes[indexE];
+
+			b.Child1 = indexA;
+			b.Parent = a.Parent;
+			a.Parent = indexB;
+
+			if (b.Parent == _nullNode)
+			{
+				_root = indexB;
+			}
+			else if (_nodes[b.Parent].Child1 == indexA)
+			{
+				_nodes[b.Parent].Child1 = indexB;
+			}
+			else
+			{
+				_nodes[b.Parent].Child2 = indexB;
+			}
+
+			if (d.Height > e.Height)
+			{
+				b.Child2 = indexD;
+				a.Child1 = indexE;
+				e.Parent = indexA;
+				a.Bounds = combine(c.Bounds, e.Bounds);
+				b.Bounds = combine(a.Bounds, d.Bounds);
+				a.Height = 1 + std::max(c.Height, e.Height);
+				b.Height = 1 + std::max(a.Height, d.Height);
+			}
+			else
+			{
+				b.Child2 = indexE;
+				a.Child1 = indexD;
+				d.Parent = indexA;
+				a.Bounds = combine(c.Bounds, d.Bounds);
+				b.Bounds = combine(a.Bounds, e.Bounds);
+				a.Height = 1 + std::max(c.Height, d.Height);
+				b.Height = 1 + std::max(a.Height, e.Height);
+			}
+
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+	void DynamicTree::Update(std::span<const SimplifiedCollider> colliders) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(update, "DynamicTree::Update", true);
+#endif
+
+		_updateCount++;
+
+		for (const auto& collider : colliders)
+		{
+			const auto index = collider.Ref.Index;
+
+			if (index >= _proxies.size())
+			{
+				_proxies.resize(index + 1, DynamicTreeProxy { _nullNode });
+			}
+
+			auto& proxy = _proxies[index];
+
+			if (proxy.Leaf == _nullNode)
+			{
+				proxy.Leaf = allocateNode();
+				_nodes[proxy.Leaf].Bounds = fatten(collider.Bounds, Math::Vec2F::Zero());
+				insertLeaf(proxy.Leaf);
+			}
+			else
+			{
+				const auto& fatBounds = _nodes[proxy.Leaf].Bounds;
+
+				if (!fatBounds.Contains(collider.Bounds.MinBound()) || !fatBounds.Contains(collider.Bounds.MaxBound()))
+				{
+					const auto displacement = collider.Bounds.Center() - proxy.Bounds.Center();
+
+					removeLeaf(proxy.Leaf);
+					_nodes[proxy.Leaf].Bounds = fatten(collider.Bounds, displacement);
+					insertLeaf(proxy.Leaf);
+				}
+			}
+
+			_nodes[proxy.Leaf].Ref = collider.Ref;
+			proxy.Bounds = collider.Bounds;
+			proxy.LastUpdate = _updateCount;
+		}
+
+		// Remove the colliders that were not given, they have been disabled or destroyed
+		for (auto& proxy : _proxies)
+		{
+			if (proxy.Leaf == _nullNode || proxy.LastUpdate == _updateCount) continue;
+
+			removeLeaf(proxy.Leaf);
+			freeNode(proxy.Leaf);
+			proxy.Leaf = _nullNode;
+		}
+	}
+
+	void DynamicTree::addAllPossiblePairs(std::size_t index) noexcept
+	{
+		if (isLeaf(index)) return;
+
+		const auto& node = _nodes[index];
+
+		addAllPossiblePairs(node.Child1, node.Child2);
+		addAllPossiblePairs(node.Child1);
+		addAllPossiblePairs(node.Child2);
+	}
+
+	void DynamicTree::addAllPossiblePairs(std::size_t indexA, std::size_t indexB) noexcept
+	{
+		const auto& nodeA = _nodes[indexA];
+		const auto& nodeB = _nodes[indexB];
+
+		if (!Math::Intersect(nodeA.Bounds, nodeB.Bounds)) return;
+
+		const auto leafA = isLeaf(indexA);
+		const auto leafB = isLeaf(indexB);
+
+		if (leafA && leafB)
+		{
+			// The enlarged bounds overlap, check the real ones
+			if (Math::Intersect(_proxies[nodeA.Ref.Index].Bounds, _proxies[nodeB.Ref.Index].Bounds))
+			{
+				_allPossiblePairs.push_back(ColliderPair{nodeA.Ref, nodeB.Ref});
+			}
+
+			return;
+		}
+
+		// Descend into the biggest node
+		if (leafB || (!leafA && perimeter(nodeA.Bounds) > perimeter(nodeB.Bounds)))
+		{
+			addAllPossiblePairs(nodeA.Child1, indexB);
+			addAllPossiblePairs(nodeA.Child2, indexB);
+		}
+		else
+		{
+			addAllPossiblePairs(indexA, nodeB.Child1);
+			addAllPossiblePairs(indexA, nodeB.Child2);
+		}
+	}
+
+	const MyVector<ColliderPair>& DynamicTree::GetAllPossiblePairs() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(GetAllPossiblePairs, "DynamicTree::GetAllPossiblePairs", true);
+#endif
+
+		_allPossiblePairs.clear();
+
+		if (_root != _nullNode)
+		{
+			addAllPossiblePairs(_root);
+		}
+
+		return _allPossiblePairs;
+	}
+
+	void DynamicTree::query(std::size_t index, const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+		const auto& node = _nodes[index];
+
+		if (!Math::Intersect(node.Bounds, bounds)) return;
+
+		if (isLeaf(index))
+		{
+			if (Math::Intersect(_proxies[node.Ref.Index].Bounds, bounds))
+			{
+				results.push_back(node.Ref);
+			}
+
+			return;
+		}
+
+		query(node.Child1, bounds, results);
+		query(node.Child2, bounds, results);
+	}
+
+	void DynamicTree::Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(query, "DynamicTree::Query", true);
+#endif
+
+		if (_root != _nullNode)
+		{
+			query(_root, bounds, results);
+		}
+	}
+
+	std::vector<Math::RectangleF> DynamicTree::GetBoundaries() const noexcept
+	{
+		std::vector<Math::RectangleF> boundaries;
+
+		boundaries.reserve(_nodes.size());
+
+		for (const auto& node : _nodes)
+		{
+			if (node.Height < 0) continue;
+
+			boundaries.push_back(node.Bounds);
+		}
+
+		return boundaries;
+	}
+
+	std::size_t DynamicTree::GetCollidersCount() const noexcept
+	{
+		std::size_t count = 0;
+
+		for (const auto& proxy : _proxies)
+		{
+			if (proxy.Leaf != _nullNode) count++;
+		}
+
+		return count;
+	}
+
+	int DynamicTree::GetHeight() const noexcept
+	{
+		if (_root == _nullNode) return 0;
+
+		return _nodes[_root].Height;
+	}
+}
\ No newline at end of file
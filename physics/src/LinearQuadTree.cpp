@@ -0,0 +1,363 @@
+#include "LinearQuadTree.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Physics
+{
+	std::uint32_t LinearQuadTree::spreadBits(std::uint32_t value) noexcept
+	{
+		value &= 0x0000FFFF;
+		value = (value | value << 8) & 0x00FF00FF;
+		value = (value | value << 4) & 0x0F0F0F0F;
+		value = (value | value << 2) & 0x33333333;
+		value = (value | value << 1) & 0x55555555;
+
+		return value;
+	}
+
+	void LinearQuadTree::radixSort() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(radixSort, "LinearQuadTree::radixSort", true);
+#endif
+
+		const auto count = _keys.size();
+
+		_tempKeys.resize(count);
+		_tempIndices.resize(count);
+
+		for (std::uint32_t shift = 0; shift < 32; shift += 8)
+		{
+			std::array<std::size_t, 257> starts {};
+
+			for (const auto key : _keys)
+			{
+				starts[(key >> shift & 0xFF) + 1]++;
+			}
+
+			// All the keys have the same digit, the pass would not change the order
+			if (std::find(starts.begin(), starts.end(), count) != starts.end()) continue;
+
+			for (std::size_t i = 1; i < starts.size(); i++)
+			{
+				starts[i] += starts[i - 1];
+			}
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const auto position = starts[_keys[i] >> shift & 0xFF]++;
+
+				_tempKeys[position] = _keys[i];
+				_tempIndices[position] = _indices[i];
+			}
+
+			std::swap(_keys, _tempKeys);
+			std::swap(_indices, _tempIndices);
+		}
+	}
+
+	void LinearQuadTree::build(std::uint32_t level, std::uint32_t cell, std::uint32_t begin, std::uint32_t end) noexcept
+	{
+		const auto ownKey = cell << _levelBits | level;
+		const auto ownEnd = static_cast<std::uint32_t>(std::upper_bound(_keys.begin() + begin, _keys.begin() + end, ownKey) - _keys.begin());
+		const auto childShift = level < _maxLevel ? 2 * (_maxLevel - level - 1) : 0;
+
+		// A cell without colliders and with only one child does not need a node
+		if (ownEnd == begin)
+		{
+			const auto firstChild = (_keys[begin] >> _levelBits) >> childShift;
+			const auto lastChild = (_keys[end - 1] >> _levelBits) >> childShift;
+
+			if (firstChild == lastChild)
+			{
+				build(level + 1, firstChild << childShift, begin, end);
+				return;
+			}
+		}
+
+		const auto nodeIndex = _nodes.size();
+
+		_nodes.push_back(LinearQuadNode{Math::RectangleF(Math::Vec2F::Zero(), Math::Vec2F::Zero()), Math::RectangleF(Math::Vec2F::Zero(), Math::Vec2F::Zero()), begin, ownEnd, end, 0});
+
+		if (level < _maxLevel)
+		{
+			const auto childSize = 1u << childShift;
+			auto current = ownEnd;
+
+			for (std::uint32_t i = 0; i < 4 && current < end; i++)
+			{
+				const auto childCell = cell + i * childSize;
+				const auto childEnd = i == 3 ? end : static_cast<std::uint32_t>(
+					std::lower_bound(_keys.begin() + current, _keys.begin() + end, (childCell + childSize) << _levelBits) - _keys.begin()
+				);
+
+				if (current == childEnd) continue;
+
+				build(level + 1, childCell, current, childEnd);
+				current = childEnd;
+			}
+		}
+
+		_nodes[nodeIndex].Next = static_cast<std::uint32_t>(_nodes.size());
+	}
+
+	void LinearQuadTree::Update(std::span<const SimplifiedCollider> colliders) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(update, "LinearQuadTree::Update", true);
+#endif
+
+		const auto count = colliders.size();
+
+		_nodes.clear();
+		_colliders.resize(count);
+		_keys.resize(count);
+		_indices.resize(count);
+
+		if (count == 0) return;
+
+		auto min = colliders[0].Bounds.MinBound();
+		auto max = colliders[0].Bounds.MaxBound();
+
+		for (const auto& collider : colliders)
+		{
+			min = Math::Vec2F(std::min(min.X, collider.Bounds.MinBound().X), std::min(min.Y, collider.Bounds.MinBound().Y));
+			max = Math::Vec2F(std::max(max.X, collider.Bounds.MaxBound().X), std::max(max.Y, collider.Bounds.MaxBound().Y));
+		}
+
+		const auto size = max - min;
+		const auto cellCount = 1u << _maxLevel;
+		const auto scale = Math::Vec2F(
+			size.X > 0.f ? static_cast<float>(cellCount) / size.X : 0.f,
+			size.Y > 0.f ? static_cast<float>(cellCount) / size.Y : 0.f
+		);
+
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			const auto& bounds = colliders[i].Bounds;
+			const auto center = bounds.Center();
+			const auto colliderSize = bounds.Size();
+
+			// The deepest level where the cells are bigger than the collider
+			std::uint32_t level = 0;
+
+			while (level < _maxLevel)
+			{
+				const auto levelScale = static_cast<float>(1u << (level + 1));
+
+				if (colliderSize.X * levelScale > size.X || colliderSize.Y * levelScale > size.Y) break;
+
+				level++;
+			}
+
+			const auto x = std::min(static_cast<std::uint32_t>((center.X - min.X) * scale.X), cellCount - 1);
+			const auto y = std::min(static_cast<std::uint32_t>((center.Y - min.Y) * scale.Y), cellCount - 1);
+			const auto levelShift = 2 * (_maxLevel - level);
+			const auto cell = (spreadBits(x) | spreadBits(y) << 1) >> levelShift << levelShift;
+
+			_keys[i] = cell << _levelBits | level;
+			_indices[i] = i;
+		}
+
+		radixSort();
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			_colliders[i] = colliders[_indices[i]];
+		}
+
+		build(0, 0, 0, static_cast<std::uint32_t>(count));
+
+		// The children are after their parent, compute their bounds first
+		for (auto i = _nodes.size(); i-- > 0;)
+		{
+			auto& node = _nodes[i];
+			auto nodeMin = Math::Vec2F(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+			auto nodeMax = Math::Vec2F(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+			const auto addBounds = [&nodeMin, &nodeMax](const Math::RectangleF& bounds) {
+				nodeMin = Math::Vec2F(std::min(nodeMin.X, bounds.MinBound().X), std::min(nodeMin.Y, bounds.MinBound().Y));
+				nodeMax = Math::Vec2F(std::max(nodeMax.X, bounds.MaxBound().X), std::max(nodeMax.Y, bounds.MaxBound().Y));
+			};
+
+			for (auto j = node.Begin; j < node.OwnEnd; j++)
+			{
+				addBounds(_colliders[j].Bounds);
+			}
+
+			node.OwnBounds = Math::RectangleF(nodeMin, nodeMax);
+
+			for (auto j = i + 1; j < node.Next; j = _nodes[j].Next)
+			{
+				addBounds(_nodes[j].Bounds);
+			}
+
+			node.Bounds = Math::RectangleF(nodeMin, nodeMax);
+		}
+	}
+
+	void LinearQuadTree::addOverlappingPairs(std::size_t begin, std::size_t end, std::size_t otherBegin, std::size_t otherEnd, MyVector<ColliderPair>& pairs) const noexcept
+	{
+		for (auto position = begin; position < end; position++)
+		{
+			const auto& collider = _colliders[position];
+
+			for (auto j = std::max(otherBegin, position + 1); j < otherEnd; j++)
+			{
+				const auto& other = _colliders[j];
+
+				if (Math::Intersect(collider.Bounds, other.Bounds))
+				{
+					pairs.push_back(ColliderPair{collider.Ref, other.Ref});
+				}
+			}
+		}
+	}
+
+	void LinearQuadTree::addAllPossiblePairs(std::size_t begin, std::size_t end, MyVector<ColliderPair>& pairs) const noexcept
+	{
+		for (auto index = begin; index < end; index++)
+		{
+			const auto& node = _nodes[index];
+
+			if (node.Begin == node.OwnEnd) continue;
+
+			addOverlappingPairs(node.Begin, node.OwnEnd, node.Begin, node.OwnEnd, pairs);
+
+			// The children come first, then the next nodes, whose colliders can reach over the border of their cell.
+			// The nodes before this one have already checked their colliders against it.
+			auto i = index + 1;
+
+			while (i < _nodes.size())
+			{
+				const auto& other = _nodes[i];
+
+				if (!Math::Intersect(other.Bounds, node.OwnBounds))
+				{
+					i = other.Next;
+					continue;
+				}
+
+				if (other.Begin != other.OwnEnd && Math::Intersect(other.OwnBounds, node.OwnBounds))
+				{
+					addOverlappingPairs(node.Begin, node.OwnEnd, other.Begin, other.OwnEnd, pairs);
+				}
+
+				i++;
+			}
+		}
+	}
+
+	const MyVector<ColliderPair>& LinearQuadTree::GetAllPossiblePairs() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(GetAllPossiblePairs, "LinearQuadTree::GetAllPossiblePairs", true);
+#endif
+
+		_allPossiblePairs.clear();
+
+		if (_threadPool == nullptr || _threadPool->GetThreadCount() == 1)
+		{
+			addAllPossiblePairs(0, _nodes.size(), _allPossiblePairs);
+
+			return _allPossiblePairs;
+		}
+
+		// Split the nodes in tasks that do not depend on the number of threads, then concatenate their pairs in order
+		const auto taskCount = (_nodes.size() + _nodesPerTask - 1) / _nodesPerTask;
+
+		while (_taskPairs.size() < taskCount)
+		{
+			_taskPairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+		}
+
+		_threadPool->ParallelFor(taskCount, [this](std::size_t i) {
+			const auto begin = i * _nodesPerTask;
+
+			_taskPairs[i].clear();
+			addAllPossiblePairs(begin, std::min(begin + _nodesPerTask, _nodes.size()), _taskPairs[i]);
+		});
+
+		std::size_t pairCount = 0;
+
+		for (std::size_t i = 0; i < taskCount; i++)
+		{
+			pairCount += _taskPairs[i].size();
+		}
+
+		_allPossiblePairs.reserve(pairCount);
+
+		for (std::size_t i = 0; i < taskCount; i++)
+		{
+			_allPossiblePairs.insert(_allPossiblePairs.end(), _taskPairs[i].begin(), _taskPairs[i].end());
+		}
+
+		return _allPossiblePairs;
+	}
+
+	std::vector<Math::RectangleF> LinearQuadTree::GetBoundaries() const noexcept
+	{
+		std::vector<Math::RectangleF> boundaries;
+
+		boundaries.reserve(_nodes.size());
+
+		for (const auto& node : _nodes)
+		{
+			boundaries.push_back(node.Bounds);
+		}
+
+		return boundaries;
+	}
+
+	void LinearQuadTree::Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(query, "LinearQuadTree::Query", true);
+#endif
+
+		std::size_t i = 0;
+
+		while (i < _nodes.size())
+		{
+			const auto& node = _nodes[i];
+
+			if (!Math::Intersect(node.Bounds, bounds))
+			{
+				i = node.Next;
+				continue;
+			}
+
+			for (auto j = node.Begin; j < node.OwnEnd; j++)
+			{
+				const auto& collider = _colliders[j];
+
+				if (Math::Intersect(collider.Bounds, bounds))
+				{
+					results.push_back(collider.Ref);
+				}
+			}
+
+			i++;
+		}
+	}
+
+	void LinearQuadTree::SetThreadPool(ThreadPool* threadPool) noexcept
+	{
+		_threadPool = threadPool;
+	}
+
+	std::size_t LinearQuadTree::GetCollidersCount() const noexcept
+	{
+		return _colliders.size();
+	}
+
+	std::size_t LinearQuadTree::GetNodesCount() const noexcept
+	{
+		return _nodes.size();
+	}
+}
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "QuadTree.h"
 
+#include "Intrinsics.h"
+
+#include <algorithm>
+#include <bit>
+
 #ifdef TRACY_ENABLE
 #include <tracy/Tracy.hpp>
 #include <fmt/format.h>
@@ -8,10 +13,16 @@
 namespace Physics
 {
 	QuadNode::QuadNode(HeapAllocator& allocator) noexcept :
-		Colliders {StandardAllocator<SimplifiedCollider> {allocator}} {}
-
-	QuadTree::QuadTree(const Math::RectangleF& boundary) noexcept :
-		_nodesAllocator(std::malloc((getMaxNodes()) * sizeof(QuadNode) * 2), (getMaxNodes()) * sizeof(QuadNode) * 2)
+		Refs {StandardAllocator<ColliderRef> {allocator}},
+		MinX {StandardAllocator<float> {allocator}},
+		MinY {StandardAllocator<float> {allocator}},
+		MaxX {StandardAllocator<float> {allocator}},
+		MaxY {StandardAllocator<float> {allocator}} {}
+
+	QuadTree::QuadTree(const Math::RectangleF& boundary, bool incremental, float looseness) noexcept :
+		_nodesAllocator(std::malloc((getMaxNodes()) * sizeof(QuadNode) * 2), (getMaxNodes()) * sizeof(QuadNode) * 2),
+		_incremental(incremental),
+		_looseness(std::max(looseness, 1.f))
     {
 		_nodes.resize(getMaxNodes(), QuadNode {_heapAllocator});
 
@@ -55,110 +66,498 @@ namespace Physics
 
         _nodes[index].Divided = true;
 
-        const auto colliders = node.Colliders;
+        // Move the colliders to the children, the ones on several children stay at the start of the node
+        std::size_t count = 0;
 
-        node.Colliders.clear();
-
-        for (const auto& collider : colliders)
+        for (std::size_t i = 0; i < node.Refs.size(); i++)
         {
-            std::size_t targetIndex = 0;
+            const auto collider = getCollider(node, i);
+            const auto targetIndex = getTargetChild(index, collider.Bounds);
 
-            for (auto i = 1; i <= 4; i++)
+            if (targetIndex == index)
             {
-                const auto& child = _nodes[index * 4 + i];
+                setCollider(index, count++, collider);
+                continue;
+            }
 
-                if (Math::Intersect(child.Boundary, collider.Bounds))
-                {
-                    if (targetIndex != 0)
-                    {
-                        targetIndex = index;
-                        break;
-                    }
+            pushCollider(targetIndex, collider);
+        }
 
-                    targetIndex = index * 4 + i;
-                }
+        resizeColliders(node, count);
+    }
+
+    std::size_t QuadTree::getTargetChild(std::size_t index, const Math::RectangleF& bounds) const noexcept
+    {
+        if (_looseness > 1.f)
+        {
+            const auto center = bounds.Center();
+            const auto nodeCenter = _nodes[index].Boundary.Center();
+            const auto childIndex = index * 4 + 1 + (center.X >= nodeCenter.X ? 1 : 0) + (center.Y >= nodeCenter.Y ? 2 : 0);
+
+            return fits(childIndex, bounds) ? childIndex : index;
+        }
+
+        std::size_t targetIndex = index;
+
+        for (auto i = 1; i <= 4; i++)
+        {
+            const auto childIndex = index * 4 + i;
+
+            if (Math::Intersect(_nodes[childIndex].Boundary, bounds))
+            {
+                if (targetIndex != index) return index;
+
+                targetIndex = childIndex;
             }
+        }
+
+        return targetIndex;
+    }
+
+    bool QuadTree::fits(std::size_t index, const Math::RectangleF& bounds) const noexcept
+    {
+        const auto& boundary = _nodes[index].Boundary;
+        const auto& min = bounds.MinBound();
+        const auto& max = bounds.MaxBound();
+
+        if (index == 0)
+        {
+            return boundary.Contains(min) && boundary.Contains(max);
+        }
+
+        if (_looseness > 1.f)
+        {
+            const auto& looseBoundary = _nodes[index].LooseBoundary;
 
-            _nodes[targetIndex].Colliders.push_back(collider);
+            return looseBoundary.Contains(min) && looseBoundary.Contains(max);
         }
+
+        const auto& boundaryMin = boundary.MinBound();
+        const auto& boundaryMax = boundary.MaxBound();
+
+        return min.X > boundaryMin.X && min.Y > boundaryMin.Y && max.X < boundaryMax.X && max.Y < boundaryMax.Y;
     }
 
-	void QuadTree::Insert(SimplifiedCollider collider) noexcept
-	{
-#ifdef TRACY_ENABLE
-		ZoneNamedN(insert, "QuadTree::Insert", true);
-#endif
+    void QuadTree::setColliderSlot(ColliderRef colliderRef, std::size_t index, std::size_t position) noexcept
+    {
+        if (colliderRef.Index >= _colliderNodes.size() || _colliderNodes[colliderRef.Index] == _noNode) return;
 
-        std::size_t parentIndex = 0;
+        _colliderNodes[colliderRef.Index] = index;
+        _colliderSlots[colliderRef.Index] = position;
+    }
 
+	void QuadTree::insert(std::size_t index, SimplifiedCollider collider) noexcept
+	{
         while (true)
         {
-            auto& node = _nodes[parentIndex];
+            auto& node = _nodes[index];
 
             if (node.Divided)
             {
                 // Check if it collides with more than one child
                 // True -> Push it in the parent
-                // False -> If parentIndex is at max depth, put it in, if not, set parentIndex to it
-                std::size_t targetIndex = 0;
+                // False -> Go to the child and check again
+                const auto targetIndex = getTargetChild(index, collider.Bounds);
 
-                for (auto i = 1; i <= 4; i++)
+                if (targetIndex != index)
                 {
-                    const auto& child = _nodes[parentIndex * 4 + i];
-
-                    if (Math::Intersect(child.Boundary, collider.Bounds))
-                    {
-                        if (targetIndex != 0)
-                        {
-                            targetIndex = parentIndex;
-                            break;
-                        }
-
-                        targetIndex = parentIndex * 4 + i;
-                    }
+                    index = targetIndex;
+                    continue;
                 }
 
-                if (targetIndex != parentIndex)
-                {
-                    parentIndex = targetIndex;
-                }
-                else
-                {
-                    _nodes[targetIndex].Colliders.push_back(collider);
-                    break;
-                }
+                pushCollider(index, collider);
+                break;
             }
-            else
-            {
-                node.Colliders.push_back(collider);
 
-                if (node.Colliders.size() > _maxCapacity && getDepth(parentIndex) < _maxDepth)
-                {
-                    subdivide(parentIndex);
-                }
+            pushCollider(index, collider);
 
-                break;
+            if (node.Refs.size() > _maxCapacity && getDepth(index) < _maxDepth)
+            {
+                subdivide(index);
             }
+
+            break;
         }
 	}
 
-	void QuadTree::addAllPossiblePairs(std::size_t index, const SimplifiedCollider& collider) noexcept
+	void QuadTree::Update(std::span<const SimplifiedCollider> colliders) noexcept
 	{
 #ifdef TRACY_ENABLE
-		ZoneScoped;
+		ZoneNamedN(update, "QuadTree::Update", true);
 #endif
-		const auto& node = _nodes[index];
 
-		for (const auto & otherCollider : node.Colliders)
+		if (!_incremental)
 		{
-			if (collider.Ref == otherCollider.Ref) continue;
+			// Calculate minimum and maximum bounds of all colliders
+			float minX = std::numeric_limits<float>::max();
+			float minY = std::numeric_limits<float>::max();
+			float maxX = std::numeric_limits<float>::min();
+			float maxY = std::numeric_limits<float>::min();
+
+			for (const auto& collider : colliders)
+			{
+				const auto& min = collider.Bounds.MinBound();
+				const auto& max = collider.Bounds.MaxBound();
 
-			if (Math::Intersect(otherCollider.Bounds, collider.Bounds))
+				if (min.X < minX) minX = min.X;
+				if (min.Y < minY) minY = min.Y;
+				if (max.X > maxX) maxX = max.X;
+				if (max.Y > maxY) maxY = max.Y;
+			}
+
+			ClearColliders();
+			UpdateBoundary(Math::RectangleF({ minX, minY }, { maxX, maxY }));
+
+			for (const auto& collider : colliders)
 			{
-				_allPossiblePairs.push_back(ColliderPair{collider.Ref, otherCollider.Ref});
+				Insert(collider);
 			}
+
+			return;
 		}
 
+		_updateCount++;
+		_updatedColliders.clear();
+
+		std::size_t keptCount = 0;
+
+		for (const auto& collider : colliders)
+		{
+			const auto colliderIndex = collider.Ref.Index;
+
+			if (Contains(collider.Ref) && _colliderUpdates[colliderIndex] + 1 == _updateCount)
+			{
+				keptCount++;
+			}
+
+			UpdateCollider(collider);
+
+			_colliderUpdates[colliderIndex] = _updateCount;
+			_updatedColliders.push_back(colliderIndex);
+		}
+
+		// The colliders of the last update that are not given again have been disabled or destroyed, there are none when all of them were kept
+		if (keptCount != _lastUpdatedColliders.size())
+		{
+			for (const auto colliderIndex : _lastUpdatedColliders)
+			{
+				if (_colliderUpdates[colliderIndex] == _updateCount) continue;
+
+				RemoveCollider({ colliderIndex, 0 });
+			}
+		}
+
+		std::swap(_lastUpdatedColliders, _updatedColliders);
+	}
+
+	void QuadTree::Insert(SimplifiedCollider collider) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(insert, "QuadTree::Insert", true);
+#endif
+
+        insert(0, collider);
+	}
+
+    std::size_t QuadTree::countColliders(std::size_t index, std::size_t limit) const noexcept
+    {
+        const auto& node = _nodes[index];
+        std::size_t count = node.Refs.size();
+
+        if (!node.Divided) return count;
+
+        for (auto i = 1; i <= 4 && count <= limit; i++)
+        {
+            count += countColliders(index * 4 + i, limit);
+        }
+
+        return count;
+    }
+
+    void QuadTree::merge(std::size_t index) noexcept
+    {
+        auto& node = _nodes[index];
+
+        for (auto i = 1; i <= 4; i++)
+        {
+            const auto childIndex = index * 4 + i;
+            auto& child = _nodes[childIndex];
+
+            if (child.Divided)
+            {
+                merge(childIndex);
+            }
+
+            for (std::size_t j = 0; j < child.Refs.size(); j++)
+            {
+                pushCollider(index, getCollider(child, j));
+            }
+
+            resizeColliders(child, 0);
+        }
+
+        node.Divided = false;
+    }
+
+    void QuadTree::mergeParents(std::size_t index) noexcept
+    {
+        while (index != 0)
+        {
+            index = (index - 1) / 4;
+
+            if (countColliders(index, _maxCapacity) > _maxCapacity) break;
+
+            merge(index);
+        }
+    }
+
+    void QuadTree::rebuild(SimplifiedCollider collider) noexcept
+    {
+#ifdef TRACY_ENABLE
+        ZoneNamedN(rebuild, "QuadTree::rebuild", true);
+#endif
+
+        MyVector<SimplifiedCollider> colliders { StandardAllocator<SimplifiedCollider> {_heapAllocator} };
+
+        colliders.reserve(GetAllCollidersCount() + 1);
+        colliders.push_back(collider);
+
+        for (const auto& node : _nodes)
+        {
+            for (std::size_t i = 0; i < node.Refs.size(); i++)
+            {
+                colliders.push_back(getCollider(node, i));
+            }
+        }
+
+        auto min = collider.Bounds.MinBound();
+        auto max = collider.Bounds.MaxBound();
+
+        for (const auto& other : colliders)
+        {
+            const auto& otherMin = other.Bounds.MinBound();
+            const auto& otherMax = other.Bounds.MaxBound();
+
+            if (otherMin.X < min.X) min.X = otherMin.X;
+            if (otherMin.Y < min.Y) min.Y = otherMin.Y;
+            if (otherMax.X > max.X) max.X = otherMax.X;
+            if (otherMax.Y > max.Y) max.Y = otherMax.Y;
+        }
+
+        // Keep some space around the colliders to avoid a rebuild each time a collider moves on the border
+        const auto margin = (max - min + Math::Vec2F::One()) * _growthMargin;
+
+        ClearColliders();
+        UpdateBoundary(Math::RectangleF(min - margin, max + margin));
+
+        for (const auto& other : colliders)
+        {
+            _colliderNodes[other.Ref.Index] = 0;
+            insert(0, other);
+        }
+    }
+
+    void QuadTree::UpdateCollider(SimplifiedCollider collider) noexcept
+    {
+#ifdef TRACY_ENABLE
+        ZoneNamedN(updateCollider, "QuadTree::UpdateCollider", true);
+#endif
+
+        const auto colliderIndex = collider.Ref.Index;
+
+        if (colliderIndex >= _colliderNodes.size())
+        {
+            _colliderNodes.resize(colliderIndex + 1, _noNode);
+            _colliderSlots.resize(colliderIndex + 1, 0);
+            _colliderUpdates.resize(colliderIndex + 1, 0);
+        }
+
+        const auto nodeIndex = _colliderNodes[colliderIndex];
+
+        if (nodeIndex == _noNode)
+        {
+            _colliderNodes[colliderIndex] = 0;
+
+            if ((_nodes[0].Refs.empty() && !_nodes[0].Divided) || !fits(0, collider.Bounds))
+            {
+                rebuild(collider);
+                return;
+            }
+
+            insert(0, collider);
+            return;
+        }
+
+        const auto position = _colliderSlots[colliderIndex];
+
+        // Still inside its node and cannot go in a child, only update its bounds
+        if (fits(nodeIndex, collider.Bounds) && (!_nodes[nodeIndex].Divided || getTargetChild(nodeIndex, collider.Bounds) == nodeIndex))
+        {
+            setCollider(nodeIndex, position, collider);
+            return;
+        }
+
+        eraseCollider(nodeIndex, position);
+
+        // Go up until a node contains the collider and insert it from there
+        std::size_t parentIndex = nodeIndex;
+
+        while (parentIndex != 0 && !fits(parentIndex, collider.Bounds))
+        {
+            parentIndex = (parentIndex - 1) / 4;
+        }
+
+        if (!fits(parentIndex, collider.Bounds))
+        {
+            rebuild(collider);
+            return;
+        }
+
+        insert(parentIndex, collider);
+        mergeParents(nodeIndex);
+    }
+
+    void QuadTree::RemoveCollider(ColliderRef colliderRef) noexcept
+    {
+        if (!Contains(colliderRef)) return;
+
+        const auto nodeIndex = _colliderNodes[colliderRef.Index];
+
+        eraseCollider(nodeIndex, _colliderSlots[colliderRef.Index]);
+
+        _colliderNodes[colliderRef.Index] = _noNode;
+
+        mergeParents(nodeIndex);
+    }
+
+    bool QuadTree::Contains(ColliderRef colliderRef) const noexcept
+    {
+        return colliderRef.Index < _colliderNodes.size() && _colliderNodes[colliderRef.Index] != _noNode;
+    }
+
+    void QuadTree::pushCollider(std::size_t index, const SimplifiedCollider& collider) noexcept
+    {
+        auto& node = _nodes[index];
+
+        setColliderSlot(collider.Ref, index, node.Refs.size());
+
+        node.Refs.push_back(collider.Ref);
+        node.MinX.push_back(collider.Bounds.MinBound().X);
+        node.MinY.push_back(collider.Bounds.MinBound().Y);
+        node.MaxX.push_back(collider.Bounds.MaxBound().X);
+        node.MaxY.push_back(collider.Bounds.MaxBound().Y);
+    }
+
+    SimplifiedCollider QuadTree::getCollider(const QuadNode& node, std::size_t position) noexcept
+    {
+        return {
+            node.Refs[position],
+            Math::RectangleF(
+                Math::Vec2F(node.MinX[position], node.MinY[position]),
+                Math::Vec2F(node.MaxX[position], node.MaxY[position])
+            )
+        };
+    }
+
+    void QuadTree::setCollider(std::size_t index, std::size_t position, const SimplifiedCollider& collider) noexcept
+    {
+        auto& node = _nodes[index];
+
+        setColliderSlot(collider.Ref, index, position);
+
+        node.Refs[position] = collider.Ref;
+        node.MinX[position] = collider.Bounds.MinBound().X;
+        node.MinY[position] = collider.Bounds.MinBound().Y;
+        node.MaxX[position] = collider.Bounds.MaxBound().X;
+        node.MaxY[position] = collider.Bounds.MaxBound().Y;
+    }
+
+    void QuadTree::eraseCollider(std::size_t index, std::size_t position) noexcept
+    {
+        auto& node = _nodes[index];
+        const auto last = node.Refs.size() - 1;
+
+        setColliderSlot(node.Refs[last], index, position);
+
+        node.Refs[position] = node.Refs[last];
+        node.MinX[position] = node.MinX[last];
+        node.MinY[position] = node.MinY[last];
+        node.MaxX[position] = node.MaxX[last];
+        node.MaxY[position] = node.MaxY[last];
+
+        resizeColliders(node, last);
+    }
+
+    void QuadTree::resizeColliders(QuadNode& node, std::size_t count) noexcept
+    {
+        node.Refs.resize(count);
+        node.MinX.resize(count);
+        node.MinY.resize(count);
+        node.MaxX.resize(count);
+        node.MaxY.resize(count);
+    }
+
+    void QuadTree::addOverlappingPairs(const QuadNode& node, std::size_t begin, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept
+    {
+        const auto& ref = collider.Ref;
+        const auto minX = collider.Bounds.MinBound().X;
+        const auto minY = collider.Bounds.MinBound().Y;
+        const auto maxX = collider.Bounds.MaxBound().X;
+        const auto maxY = collider.Bounds.MaxBound().Y;
+        const auto count = node.Refs.size();
+        auto i = begin;
+
+        // Same comparisons as Math::Intersect, written as "not greater" and "not less" to give the same result with NaN
+#ifdef __AVX__
+        const auto minX8 = _mm256_set1_ps(minX);
+        const auto minY8 = _mm256_set1_ps(minY);
+        const auto maxX8 = _mm256_set1_ps(maxX);
+        const auto maxY8 = _mm256_set1_ps(maxY);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto overlapX = _mm256_and_ps(
+                _mm256_cmp_ps(_mm256_loadu_ps(node.MinX.data() + i), maxX8, _CMP_NGT_UQ),
+                _mm256_cmp_ps(_mm256_loadu_ps(node.MaxX.data() + i), minX8, _CMP_NLT_UQ)
+            );
+            const auto overlapY = _mm256_and_ps(
+                _mm256_cmp_ps(_mm256_loadu_ps(node.MinY.data() + i), maxY8, _CMP_NGT_UQ),
+                _mm256_cmp_ps(_mm256_loadu_ps(node.MaxY.data() + i), minY8, _CMP_NLT_UQ)
+            );
+            auto mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY)));
+
+            while (mask != 0)
+            {
+                const auto& otherRef = node.Refs[i + std::countr_zero(mask)];
+
+                mask &= mask - 1;
+
+                if (ref == otherRef) continue;
+
+                pairs.push_back(ColliderPair{ref, otherRef});
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            if (node.MinX[i] > maxX || node.MaxX[i] < minX || node.MinY[i] > maxY || node.MaxY[i] < minY) continue;
+
+            if (ref == node.Refs[i]) continue;
+
+            pairs.push_back(ColliderPair{ref, node.Refs[i]});
+        }
+    }
+
+	void QuadTree::addAllPossiblePairs(std::size_t index, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneScoped;
+#endif
+		const auto& node = _nodes[index];
+
+		addOverlappingPairs(node, 0, collider, pairs);
+
 		if (node.Divided)
 		{
             const auto& nextIndex = index * 4 + 1;
@@ -166,54 +565,169 @@ namespace Physics
 
             for (auto j = nextIndex; j <= maxIndex; j++)
             {
-                addAllPossiblePairs(j, collider);
+                addAllPossiblePairs(j, collider, pairs);
             }
 		}
 	}
 
-	const MyVector<ColliderPair>& QuadTree::GetAllPossiblePairs() noexcept
+	void QuadTree::addLoosePairs(std::size_t index, std::size_t begin, const SimplifiedCollider& collider, MyVector<ColliderPair>& pairs) noexcept
 	{
-#ifdef TRACY_ENABLE
-		ZoneNamedN(GetAllPossiblePairs, "QuadTree::GetAllPossiblePairs", true);
-#endif
-		for (std::size_t parentIndex = 0; parentIndex < _nodes.size(); parentIndex++)
+		const auto& node = _nodes[index];
+
+		addOverlappingPairs(node, begin, collider, pairs);
+
+		if (!node.Divided) return;
+
+		for (auto i = index * 4 + 1; i <= index * 4 + 4; i++)
 		{
-			const auto& node = _nodes[parentIndex];
+			if (!Math::Intersect(_nodes[i].LooseBoundary, collider.Bounds)) continue;
+
+			addLoosePairs(i, 0, collider, pairs);
+		}
+	}
 
-			for (auto i = 0; i < node.Colliders.size(); i++)
+	void QuadTree::addAllPossiblePairs(const QuadPairTask& task, MyVector<ColliderPair>& pairs) noexcept
+	{
+		const auto& node = _nodes[task.Node];
+
+		for (auto i = task.Begin; i < task.End; i++)
+		{
+			const auto collider = getCollider(node, i);
+
+			// The loose boundaries of the nodes overlap, the collider can overlap colliders of the branches next to its own.
+			// The pairs with the colliders of the parents are added by them, the pairs between two branches by the first branch.
+			if (_looseness > 1.f)
 			{
-				const auto& collider = node.Colliders[i];
-                const auto& ref = collider.Ref;
-                const auto& bounds = collider.Bounds;
+				addLoosePairs(task.Node, i + 1, collider, pairs);
 
-				for (auto j = i + 1; j < node.Colliders.size(); j++)
+				for (auto index = task.Node; index > 0; index = (index - 1) / 4)
 				{
-					const auto& otherCollider = node.Colliders[j];
-
-					if (ref == otherCollider.Ref) continue;
+					const auto parent = (index - 1) / 4;
 
-					if (Math::Intersect(bounds, otherCollider.Bounds))
+					for (auto sibling = index + 1; sibling <= parent * 4 + 4; sibling++)
 					{
-						_allPossiblePairs.push_back(ColliderPair{ref, otherCollider.Ref});
+						if (!Math::Intersect(_nodes[sibling].LooseBoundary, collider.Bounds)) continue;
+
+						addLoosePairs(sibling, 0, collider, pairs);
 					}
 				}
 
-				if (node.Divided)
-				{
-                    const auto& index = parentIndex * 4 + 1;
-                    const auto& maxIndex = index + 3;
+				continue;
+			}
 
-					for (auto j = index; j <= maxIndex; j++)
-					{
-						addAllPossiblePairs(j, collider);
-					}
+			addOverlappingPairs(node, i + 1, collider, pairs);
+
+			if (node.Divided)
+			{
+                const auto& index = task.Node * 4 + 1;
+                const auto& maxIndex = index + 3;
+
+				for (auto j = index; j <= maxIndex; j++)
+				{
+					addAllPossiblePairs(j, collider, pairs);
 				}
 			}
 		}
+	}
+
+	const MyVector<ColliderPair>& QuadTree::GetAllPossiblePairs() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(GetAllPossiblePairs, "QuadTree::GetAllPossiblePairs", true);
+#endif
+		_allPossiblePairs.clear();
+
+		if (_threadPool == nullptr || _threadPool->GetThreadCount() == 1)
+		{
+			for (std::size_t index = 0; index < _nodes.size(); index++)
+			{
+				addAllPossiblePairs(QuadPairTask{index, 0, _nodes[index].Refs.size()}, _allPossiblePairs);
+			}
+
+			return _allPossiblePairs;
+		}
+
+		// Split the nodes in tasks that do not depend on the number of threads, then concatenate their pairs in order
+		_pairTasks.clear();
+
+		for (std::size_t index = 0; index < _nodes.size(); index++)
+		{
+			const auto count = _nodes[index].Refs.size();
+
+			for (std::size_t begin = 0; begin < count; begin += _collidersPerTask)
+			{
+				_pairTasks.push_back(QuadPairTask{index, begin, std::min(begin + _collidersPerTask, count)});
+			}
+		}
+
+		while (_taskPairs.size() < _pairTasks.size())
+		{
+			_taskPairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+		}
+
+		_threadPool->ParallelFor(_pairTasks.size(), [this](std::size_t i) {
+			_taskPairs[i].clear();
+			addAllPossiblePairs(_pairTasks[i], _taskPairs[i]);
+		});
+
+		std::size_t pairCount = 0;
+
+		for (std::size_t i = 0; i < _pairTasks.size(); i++)
+		{
+			pairCount += _taskPairs[i].size();
+		}
+
+		_allPossiblePairs.reserve(pairCount);
+
+		for (std::size_t i = 0; i < _pairTasks.size(); i++)
+		{
+			_allPossiblePairs.insert(_allPossiblePairs.end(), _taskPairs[i].begin(), _taskPairs[i].end());
+		}
 
 		return _allPossiblePairs;
 	}
 
+	void QuadTree::SetThreadPool(ThreadPool* threadPool) noexcept
+	{
+		_threadPool = threadPool;
+	}
+
+	void QuadTree::query(std::size_t index, const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+		const auto& node = _nodes[index];
+		const auto& min = bounds.MinBound();
+		const auto& max = bounds.MaxBound();
+
+		for (std::size_t i = 0; i < node.Refs.size(); i++)
+		{
+			if (node.MinX[i] > max.X || node.MaxX[i] < min.X || node.MinY[i] > max.Y || node.MaxY[i] < min.Y) continue;
+
+			results.push_back(node.Refs[i]);
+		}
+
+		if (!node.Divided) return;
+
+		for (auto i = index * 4 + 1; i <= index * 4 + 4; i++)
+		{
+			// The colliders of a child are inside its boundary, or its loose boundary when the quadtree is loose
+			const auto& boundary = _looseness > 1.f ? _nodes[i].LooseBoundary : _nodes[i].Boundary;
+
+			if (!Math::Intersect(boundary, bounds)) continue;
+
+			query(i, bounds, results);
+		}
+	}
+
+	void QuadTree::Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(query, "QuadTree::Query", true);
+#endif
+
+		// The root accepts the colliders on its border, it is always checked
+		query(0, bounds, results);
+	}
+
 	void QuadTree::UpdateBoundary(const Math::RectangleF& boundary) noexcept
 	{
 #ifdef TRACY_ENABLE
@@ -239,16 +753,29 @@ namespace Physics
 
             index += 4;
         }
+
+        // The root contains all the colliders, only its children are inflated
+        _nodes[0].LooseBoundary = boundary;
+
+        for (std::size_t i = 1; i < _nodes.size(); i++)
+        {
+            auto& node = _nodes[i];
+            const auto halfSize = node.Boundary.Size() * (_looseness / 2.f);
+            const auto center = node.Boundary.Center();
+
+            node.LooseBoundary = Math::RectangleF(center - halfSize, center + halfSize);
+        }
 	}
 
 	void QuadTree::ClearColliders() noexcept
 	{
 		for (auto& node : _nodes)
         {
-            node.Colliders.clear();
+            resizeColliders(node, 0);
             node.Divided = false;
         }
 
+		std::fill(_colliderNodes.begin(), _colliderNodes.end(), _noNode);
 		_allPossiblePairs.clear();
 	}
 
@@ -260,7 +787,7 @@ namespace Physics
 
         for (auto& node : _nodes)
         {
-            if (node.Colliders.empty()) continue;
+            if (node.Refs.empty()) continue;
 
             boundaries.push_back(node.Boundary);
         }
@@ -268,13 +795,18 @@ namespace Physics
 		return boundaries;
 	}
 
+	float QuadTree::GetLooseness() const noexcept
+	{
+		return _looseness;
+	}
+
 	std::size_t QuadTree::GetAllCollidersCount() const noexcept
 	{
 		std::size_t count = 0;
 
 		for (auto& node : _nodes)
         {
-            count += node.Colliders.size();
+            count += node.Refs.size();
         }
 
 		return count;
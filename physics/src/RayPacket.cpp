@@ -0,0 +1,268 @@
+#include "RayPacket.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Physics
+{
+	RayPacket::RayPacket(std::span<const Ray> rays) noexcept
+	{
+		std::array<Math::Vec2F, Size> origins {};
+		std::array<Math::Vec2F, Size> directions {};
+		std::array<Math::Vec2F, Size> inverseDirections {};
+		auto min = Math::Vec2F(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		auto max = Math::Vec2F(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			_maxDistances[i] = -1.f;
+
+			if (i >= rays.size()) continue;
+
+			const auto& ray = rays[i];
+			const auto length = ray.Direction.Length();
+
+			origins[i] = ray.Origin;
+
+			if (length == 0.f || !(ray.MaxDistance >= 0.f)) continue;
+
+			const auto direction = ray.Direction / length;
+			// A direction parallel to an axis would end at infinity times 0 on the other axis
+			const auto end = Math::Vec2F(
+				direction.X == 0.f ? ray.Origin.X : ray.Origin.X + direction.X * ray.MaxDistance,
+				direction.Y == 0.f ? ray.Origin.Y : ray.Origin.Y + direction.Y * ray.MaxDistance
+			);
+
+			directions[i] = direction;
+			inverseDirections[i] = Math::Vec2F(
+				direction.X == 0.f ? _bigInverse : 1.f / direction.X,
+				direction.Y == 0.f ? _bigInverse : 1.f / direction.Y
+			);
+			_maxDistances[i] = ray.MaxDistance;
+
+			min = Math::Vec2F(std::min({min.X, ray.Origin.X, end.X}), std::min({min.Y, ray.Origin.Y, end.Y}));
+			max = Math::Vec2F(std::max({max.X, ray.Origin.X, end.X}), std::max({max.Y, ray.Origin.Y, end.Y}));
+		}
+
+		_origins = Math::FourVec2F(origins);
+		_directions = Math::FourVec2F(directions);
+		_inverseDirections = Math::FourVec2F(inverseDirections);
+
+		if (min.X <= max.X)
+		{
+			_bounds = Math::RectangleF(min, max);
+		}
+	}
+
+	void RayPacket::addHit(std::size_t ray, ColliderRef colliderRef, float distance, Math::Vec2F normal) noexcept
+	{
+		auto& hit = _hits[ray];
+
+		// At the same distance, the first collider is kept
+		if (distance > _maxDistances[ray] || (hit.Hit && distance == _maxDistances[ray])) return;
+
+		const auto origin = Math::Vec2F(_origins.X()[ray], _origins.Y()[ray]);
+		const auto direction = Math::Vec2F(_directions.X()[ray], _directions.Y()[ray]);
+
+		hit.Collider = colliderRef;
+		hit.Point = origin + direction * distance;
+		hit.Normal = normal;
+		hit.Distance = distance;
+		hit.Hit = true;
+
+		_maxDistances[ray] = distance;
+	}
+
+	int RayPacket::intersectBounds(const Math::RectangleF& rectangle, std::array<float, Size>& entryDistances, std::array<bool, Size>& entryOnX) const noexcept
+	{
+		// Distances at which each ray crosses the lines of the sides of the rectangle
+		const auto toMin = (Math::FourVec2F(rectangle.MinBound()) - _origins) * _inverseDirections;
+		const auto toMax = (Math::FourVec2F(rectangle.MaxBound()) - _origins) * _inverseDirections;
+
+#ifdef __SSE__
+		const auto nearX = _mm_min_ps(_mm_loadu_ps(toMin.X().data()), _mm_loadu_ps(toMax.X().data()));
+		const auto farX = _mm_max_ps(_mm_loadu_ps(toMin.X().data()), _mm_loadu_ps(toMax.X().data()));
+		const auto nearY = _mm_min_ps(_mm_loadu_ps(toMin.Y().data()), _mm_loadu_ps(toMax.Y().data()));
+		const auto farY = _mm_max_ps(_mm_loadu_ps(toMin.Y().data()), _mm_loadu_ps(toMax.Y().data()));
+		const auto near = _mm_max_ps(nearX, nearY);
+		const auto far = _mm_min_ps(farX, farY);
+		const auto maxDistances = _mm_loadu_ps(_maxDistances.data());
+		const auto zero = _mm_setzero_ps();
+		const auto hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(near, far), _mm_cmpge_ps(far, zero)),
+			_mm_and_ps(_mm_cmple_ps(near, maxDistances), _mm_cmpge_ps(maxDistances, zero))
+		);
+		const auto onX = _mm_movemask_ps(_mm_cmpge_ps(nearX, nearY));
+
+		_mm_storeu_ps(entryDistances.data(), near);
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			entryOnX[i] = (onX >> i & 1) != 0;
+		}
+
+		return _mm_movemask_ps(hit);
+#else
+		int mask = 0;
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			const auto nearX = std::min(toMin.X()[i], toMax.X()[i]);
+			const auto farX = std::max(toMin.X()[i], toMax.X()[i]);
+			const auto nearY = std::min(toMin.Y()[i], toMax.Y()[i]);
+			const auto farY = std::max(toMin.Y()[i], toMax.Y()[i]);
+			const auto near = std::max(nearX, nearY);
+			const auto far = std::min(farX, farY);
+
+			entryDistances[i] = near;
+			entryOnX[i] = nearX >= nearY;
+
+			if (near <= far && far >= 0.f && near <= _maxDistances[i] && _maxDistances[i] >= 0.f)
+			{
+				mask |= 1 << i;
+			}
+		}
+
+		return mask;
+#endif
+	}
+
+	int RayPacket::IntersectBounds(const Math::RectangleF& rectangle) const noexcept
+	{
+		std::array<float, Size> entryDistances {};
+		std::array<bool, Size> entryOnX {};
+
+		return intersectBounds(rectangle, entryDistances, entryOnX);
+	}
+
+	void RayPacket::CastRectangle(const Math::RectangleF& rectangle, ColliderRef colliderRef) noexcept
+	{
+		std::array<float, Size> entryDistances {};
+		std::array<bool, Size> entryOnX {};
+		const auto mask = intersectBounds(rectangle, entryDistances, entryOnX);
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			// The rays that start inside the rectangle enter it behind their origin
+			if ((mask >> i & 1) == 0 || entryDistances[i] < 0.f) continue;
+
+			const auto normal = entryOnX[i] ?
+				Math::Vec2F(_directions.X()[i] > 0.f ? -1.f : 1.f, 0.f) :
+				Math::Vec2F(0.f, _directions.Y()[i] > 0.f ? -1.f : 1.f);
+
+			addHit(i, colliderRef, entryDistances[i], normal);
+		}
+	}
+
+	void RayPacket::CastCircle(const Math::CircleF& circle, ColliderRef colliderRef) noexcept
+	{
+		// Solve |origin + direction * t - center| = radius for the 4 rays
+		const auto center = circle.Center();
+		const auto radius = circle.Radius();
+		const auto toOrigins = _origins - Math::FourVec2F(center);
+		const auto projections = Math::FourVec2F::Dot(toOrigins, _directions);
+		const auto squareDistances = Math::FourVec2F::Dot(toOrigins, toOrigins);
+		std::array<float, Size> distances {};
+		int mask = 0;
+
+#ifdef __SSE__
+		const auto b = _mm_loadu_ps(projections.data());
+		const auto c = _mm_sub_ps(_mm_loadu_ps(squareDistances.data()), _mm_set1_ps(radius * radius));
+		const auto discriminant = _mm_sub_ps(_mm_mul_ps(b, b), c);
+		const auto t = _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), b), _mm_sqrt_ps(_mm_max_ps(discriminant, _mm_setzero_ps())));
+		const auto maxDistances = _mm_loadu_ps(_maxDistances.data());
+		const auto zero = _mm_setzero_ps();
+		const auto hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(c, zero), _mm_cmpge_ps(discriminant, zero)),
+			_mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, maxDistances))
+		);
+
+		_mm_storeu_ps(distances.data(), t);
+		mask = _mm_movemask_ps(hit);
+#else
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			const auto c = squareDistances[i] - radius * radius;
+			const auto discriminant = projections[i] * projections[i] - c;
+
+			distances[i] = -projections[i] - std::sqrt(std::max(discriminant, 0.f));
+
+			if (c >= 0.f && discriminant >= 0.f && distances[i] >= 0.f && distances[i] <= _maxDistances[i])
+			{
+				mask |= 1 << i;
+			}
+		}
+#endif
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			if ((mask >> i & 1) == 0) continue;
+
+			const auto direction = Math::Vec2F(_directions.X()[i], _directions.Y()[i]);
+			const auto point = Math::Vec2F(_origins.X()[i], _origins.Y()[i]) + direction * distances[i];
+			const auto normal = radius > 0.f ? (point - center) / radius : -direction;
+
+			addHit(i, colliderRef, distances[i], normal);
+		}
+	}
+
+	void RayPacket::CastPolygon(const Math::PolygonF& polygon, ColliderRef colliderRef, int mask) noexcept
+	{
+		const auto vertices = polygon.Vertices();
+
+		for (std::size_t i = 0; i < Size; i++)
+		{
+			if ((mask >> i & 1) == 0) continue;
+
+			const auto origin = Math::Vec2F(_origins.X()[i], _origins.Y()[i]);
+			const auto direction = Math::Vec2F(_directions.X()[i], _directions.Y()[i]);
+
+			if (polygon.Contains(origin)) continue;
+
+			auto closestDistance = _maxDistances[i];
+			auto closestEdge = Math::Vec2F::Zero();
+			auto found = false;
+
+			for (std::size_t j = 0, k = vertices.size() - 1; j < vertices.size(); k = j++)
+			{
+				// Solve origin + direction * t = start + edge * s with s in [0, 1]
+				const auto start = vertices[k];
+				const auto edge = vertices[j] - start;
+				const auto denominator = direction.X * edge.Y - direction.Y * edge.X;
+
+				if (denominator == 0.f) continue;
+
+				const auto toStart = start - origin;
+				const auto t = (toStart.X * edge.Y - toStart.Y * edge.X) / denominator;
+				const auto s = (toStart.X * direction.Y - toStart.Y * direction.X) / denominator;
+
+				if (t < 0.f || t > closestDistance || s < 0.f || s > 1.f) continue;
+
+				closestDistance = t;
+				closestEdge = edge;
+				found = true;
+			}
+
+			if (!found) continue;
+
+			auto normal = Math::Vec2F(closestEdge.Y, -closestEdge.X) / closestEdge.Length();
+
+			if (normal.Dot(direction) > 0.f)
+			{
+				normal = -normal;
+			}
+
+			addHit(i, colliderRef, closestDistance, normal);
+		}
+	}
+
+	const Math::RectangleF& RayPacket::GetBounds() const noexcept
+	{
+		return _bounds;
+	}
+
+	const std::array<RayCastHit, RayPacket::Size>& RayPacket::GetHits() const noexcept
+	{
+		return _hits;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "ShapeStorage.h"
+
+namespace Physics
+{
+	ShapeStorage::ShapeStorage(HeapAllocator& allocator) noexcept :
+		Circles {StandardAllocator<Math::CircleF> {allocator}},
+		Rectangles {StandardAllocator<Math::RectangleF> {allocator}},
+		Polygons {StandardAllocator<Math::PolygonF> {allocator}},
+		WorldCircles {StandardAllocator<Math::CircleF> {allocator}},
+		WorldRectangles {StandardAllocator<Math::RectangleF> {allocator}},
+		WorldPolygons {StandardAllocator<Math::PolygonF> {allocator}},
+		FreeCircles {StandardAllocator<std::size_t> {allocator}},
+		FreeRectangles {StandardAllocator<std::size_t> {allocator}},
+		FreePolygons {StandardAllocator<std::size_t> {allocator}} {}
+
+	std::size_t ShapeStorage::Allocate(Math::ShapeType type) noexcept
+	{
+		auto& freeShapes = type == Math::ShapeType::Circle ? FreeCircles : type == Math::ShapeType::Rectangle ? FreeRectangles : FreePolygons;
+
+		if (!freeShapes.empty())
+		{
+			const auto index = freeShapes.back();
+
+			freeShapes.pop_back();
+
+			return index;
+		}
+
+		switch (type)
+		{
+			case Math::ShapeType::Circle:
+				Circles.emplace_back(Math::Vec2F::Zero(), 0.f);
+				WorldCircles.emplace_back(Math::Vec2F::Zero(), 0.f);
+				return Circles.size() - 1;
+			case Math::ShapeType::Rectangle:
+				Rectangles.emplace_back(Math::Vec2F::Zero(), Math::Vec2F::Zero());
+				WorldRectangles.emplace_back(Math::Vec2F::Zero(), Math::Vec2F::Zero());
+				return Rectangles.size() - 1;
+			case Math::ShapeType::Polygon:
+				Polygons.emplace_back();
+				WorldPolygons.emplace_back();
+				return Polygons.size() - 1;
+			case Math::ShapeType::None: break;
+		}
+
+		return 0;
+	}
+
+	void ShapeStorage::Free(Math::ShapeType type, std::size_t index) noexcept
+	{
+		switch (type)
+		{
+			case Math::ShapeType::Circle:
+				FreeCircles.push_back(index);
+				break;
+			case Math::ShapeType::Rectangle:
+				FreeRectangles.push_back(index);
+				break;
+			case Math::ShapeType::Polygon:
+				Polygons[index] = Math::PolygonF();
+				WorldPolygons[index] = Math::PolygonF();
+				FreePolygons.push_back(index);
+				break;
+			case Math::ShapeType::None: break;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Physics
+{
+	SpatialHash::SpatialHash(float cellSize) noexcept : _cellSize(cellSize) {}
+
+	std::uint32_t SpatialHash::getBucket(std::int32_t cellX, std::int32_t cellY) const noexcept
+	{
+		const auto hash = static_cast<std::uint32_t>(cellX) * 73856093u ^ static_cast<std::uint32_t>(cellY) * 19349663u;
+
+		return hash & _bucketMask;
+	}
+
+	bool SpatialHash::fitsInCell(const Math::RectangleF& bounds) const noexcept
+	{
+		const auto size = bounds.Size();
+
+		return std::max(size.X, size.Y) * 1.001f <= _usedCellSize;
+	}
+
+	void SpatialHash::Update(std::span<const SimplifiedCollider> colliders) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(update, "SpatialHash::Update", true);
+#endif
+
+		_usedCellSize = _cellSize;
+
+		// Without a given size, the cells fit most of the colliders whatever the size of the few biggest ones
+		if (!(_usedCellSize > 0.f) && !colliders.empty())
+		{
+			_colliderSizes.resize(colliders.size());
+
+			for (std::size_t i = 0; i < colliders.size(); i++)
+			{
+				const auto size = colliders[i].Bounds.Size();
+
+				_colliderSizes[i] = std::max(size.X, size.Y);
+			}
+
+			const auto median = _colliderSizes.begin() + static_cast<std::ptrdiff_t>(_colliderSizes.size() / 2);
+
+			std::nth_element(_colliderSizes.begin(), median, _colliderSizes.end());
+			_usedCellSize = *median * 2.f;
+		}
+
+		// Also true with NaN
+		if (!(_usedCellSize > 0.f))
+		{
+			_usedCellSize = 1.f;
+		}
+
+		const auto inverseCellSize = 1.f / _usedCellSize;
+		const auto bucketCount = std::bit_ceil(static_cast<std::uint32_t>(std::max<std::size_t>(colliders.size() * 2, 1)));
+
+		_bucketMask = bucketCount - 1;
+		_bucketStarts.assign(bucketCount + 1, 0);
+		_colliderBuckets.resize(colliders.size());
+		_largeColliders.clear();
+
+		// Counting sort of the colliders by bucket, two overlapping colliders smaller than a cell are in the same cell or in neighbour cells
+		for (std::size_t i = 0; i < colliders.size(); i++)
+		{
+			if (!fitsInCell(colliders[i].Bounds))
+			{
+				_colliderBuckets[i] = _largeBucket;
+				_largeColliders.push_back(colliders[i]);
+				continue;
+			}
+
+			const auto& min = colliders[i].Bounds.MinBound();
+			const auto bucket = getBucket(
+				static_cast<std::int32_t>(std::floor(min.X * inverseCellSize)),
+				static_cast<std::int32_t>(std::floor(min.Y * inverseCellSize))
+			);
+
+			_colliderBuckets[i] = bucket;
+			_bucketStarts[bucket + 1]++;
+		}
+
+		_entries.resize(colliders.size() - _largeColliders.size());
+
+		for (std::size_t i = 1; i < _bucketStarts.size(); i++)
+		{
+			_bucketStarts[i] += _bucketStarts[i - 1];
+		}
+
+		for (std::size_t i = 0; i < colliders.size(); i++)
+		{
+			if (_colliderBuckets[i] == _largeBucket) continue;
+
+			const auto& collider = colliders[i];
+			const auto& min = collider.Bounds.MinBound();
+			auto& entry = _entries[_bucketStarts[_colliderBuckets[i]]++];
+
+			entry.Ref = collider.Ref;
+			entry.Bounds = collider.Bounds;
+			entry.CellX = static_cast<std::int32_t>(std::floor(min.X * inverseCellSize));
+			entry.CellY = static_cast<std::int32_t>(std::floor(min.Y * inverseCellSize));
+		}
+
+		// Each start has been moved to the start of the next bucket, move them back
+		for (std::size_t i = bucketCount; i > 0; i--)
+		{
+			_bucketStarts[i] = _bucketStarts[i - 1];
+		}
+
+		_bucketStarts[0] = 0;
+	}
+
+	void SpatialHash::addPairsWithCell(std::size_t entryIndex, std::int32_t cellX, std::int32_t cellY, std::size_t start) noexcept
+	{
+		const auto& entry = _entries[entryIndex];
+		const auto bucket = getBucket(cellX, cellY);
+		const auto end = static_cast<std::size_t>(_bucketStarts[bucket + 1]);
+
+		// Different cells can share a bucket, only the entries of the cell are checked
+		for (auto i = std::max(start, static_cast<std::size_t>(_bucketStarts[bucket])); i < end; i++)
+		{
+			const auto& other = _entries[i];
+
+			if (other.CellX != cellX || other.CellY != cellY) continue;
+
+			if (Math::Intersect(entry.Bounds, other.Bounds))
+			{
+				_allPossiblePairs.push_back(ColliderPair{entry.Ref, other.Ref});
+			}
+		}
+	}
+
+	const MyVector<ColliderPair>& SpatialHash::GetAllPossiblePairs() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(GetAllPossiblePairs, "SpatialHash::GetAllPossiblePairs", true);
+#endif
+
+		_allPossiblePairs.clear();
+
+		for (std::size_t i = 0; i < _entries.size(); i++)
+		{
+			const auto cellX = _entries[i].CellX;
+			const auto cellY = _entries[i].CellY;
+
+			// The entries after this one in its cell, then half of the neighbour cells, the other half checks this cell
+			addPairsWithCell(i, cellX, cellY, i + 1);
+			addPairsWithCell(i, cellX + 1, cellY, 0);
+			addPairsWithCell(i, cellX - 1, cellY + 1, 0);
+			addPairsWithCell(i, cellX, cellY + 1, 0);
+			addPairsWithCell(i, cellX + 1, cellY + 1, 0);
+		}
+
+		for (std::size_t i = 0; i < _largeColliders.size(); i++)
+		{
+			const auto& largeCollider = _largeColliders[i];
+
+			for (const auto& entry : _entries)
+			{
+				if (Math::Intersect(largeCollider.Bounds, entry.Bounds))
+				{
+					_allPossiblePairs.push_back(ColliderPair{largeCollider.Ref, entry.Ref});
+				}
+			}
+
+			for (std::size_t j = i + 1; j < _largeColliders.size(); j++)
+			{
+				if (Math::Intersect(largeCollider.Bounds, _largeColliders[j].Bounds))
+				{
+					_allPossiblePairs.push_back(ColliderPair{largeCollider.Ref, _largeColliders[j].Ref});
+				}
+			}
+		}
+
+		return _allPossiblePairs;
+	}
+
+	std::vector<Math::RectangleF> SpatialHash::GetBoundaries() const noexcept
+	{
+		std::vector<Math::RectangleF> boundaries;
+
+		for (std::size_t bucket = 0; bucket + 1 < _bucketStarts.size(); bucket++)
+		{
+			const auto start = _bucketStarts[bucket];
+			const auto end = _bucketStarts[bucket + 1];
+
+			for (auto i = start; i < end; i++)
+			{
+				const auto& entry = _entries[i];
+				const auto isFirstOfCell = std::none_of(_entries.begin() + start, _entries.begin() + i, [&entry](const SpatialHashEntry& other) {
+					return other.CellX == entry.CellX && other.CellY == entry.CellY;
+				});
+
+				if (!isFirstOfCell) continue;
+
+				const auto min = Math::Vec2F(static_cast<float>(entry.CellX), static_cast<float>(entry.CellY)) * _usedCellSize;
+
+				boundaries.emplace_back(min, min + Math::Vec2F(_usedCellSize, _usedCellSize));
+			}
+		}
+
+		return boundaries;
+	}
+
+	void SpatialHash::Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(query, "SpatialHash::Query", true);
+#endif
+
+		for (const auto& largeCollider : _largeColliders)
+		{
+			if (Math::Intersect(largeCollider.Bounds, bounds))
+			{
+				results.push_back(largeCollider.Ref);
+			}
+		}
+
+		if (_entries.empty()) return;
+
+		// A collider is in the cell of its min bound and is smaller than a cell, it can start one cell before the bounds
+		const auto inverseCellSize = 1.f / _usedCellSize;
+		const auto minX = std::floor(bounds.MinBound().X * inverseCellSize) - 1.f;
+		const auto minY = std::floor(bounds.MinBound().Y * inverseCellSize) - 1.f;
+		const auto maxX = std::floor(bounds.MaxBound().X * inverseCellSize);
+		const auto maxY = std::floor(bounds.MaxBound().Y * inverseCellSize);
+		const auto cellCount = (maxX - minX + 1.f) * (maxY - minY + 1.f);
+
+		// Also true with NaN bounds
+		if (!(cellCount <= static_cast<float>(_bucketStarts.size())))
+		{
+			for (const auto& entry : _entries)
+			{
+				if (Math::Intersect(entry.Bounds, bounds))
+				{
+					results.push_back(entry.Ref);
+				}
+			}
+
+			return;
+		}
+
+		for (auto cellY = static_cast<std::int32_t>(minY); cellY <= static_cast<std::int32_t>(maxY); cellY++)
+		{
+			for (auto cellX = static_cast<std::int32_t>(minX); cellX <= static_cast<std::int32_t>(maxX); cellX++)
+			{
+				const auto bucket = getBucket(cellX, cellY);
+
+				for (auto i = _bucketStarts[bucket]; i < _bucketStarts[bucket + 1]; i++)
+				{
+					const auto& entry = _entries[i];
+
+					if (entry.CellX != cellX || entry.CellY != cellY) continue;
+
+					if (Math::Intersect(entry.Bounds, bounds))
+					{
+						results.push_back(entry.Ref);
+					}
+				}
+			}
+		}
+	}
+
+	void SpatialHash::SetCellSize(float cellSize) noexcept
+	{
+		_cellSize = cellSize;
+	}
+
+	float SpatialHash::GetCellSize() const noexcept
+	{
+		return _usedCellSize;
+	}
+
+	std::size_t SpatialHash::GetCollidersCount() const noexcept
+	{
+		return _entries.size() + _largeColliders.size();
+	}
+
+	std::size_t SpatialHash::GetLargeCollidersCount() const noexcept
+	{
+		return _largeColliders.size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Physics
+{
+	void SweepAndPrune::insertionSort(MyVector<SweepEndpoint>& endpoints, std::size_t count) noexcept
+	{
+		for (std::size_t i = 1; i < count; i++)
+		{
+			const auto endpoint = endpoints[i];
+			std::size_t j = i;
+
+			while (j > 0 && endpoints[j - 1].Min > endpoint.Min)
+			{
+				endpoints[j] = endpoints[j - 1];
+				j--;
+			}
+
+			endpoints[j] = endpoint;
+		}
+	}
+
+	void SweepAndPrune::updateEndpoints(MyVector<SweepEndpoint>& endpoints, std::size_t sortedCount, bool onX, float& maxExtent) noexcept
+	{
+		std::size_t count = 0;
+		std::size_t keptSortedCount = 0;
+
+		maxExtent = 0.f;
+
+		for (std::size_t i = 0; i < endpoints.size(); i++)
+		{
+			auto endpoint = endpoints[i];
+			auto& proxy = _proxies[endpoint.Proxy];
+
+			if (proxy.LastUpdate != _updateCount)
+			{
+				proxy.InUse = false;
+				continue;
+			}
+
+			const auto& min = proxy.Bounds.MinBound();
+			const auto& max = proxy.Bounds.MaxBound();
+
+			endpoint.Min = onX ? min.X : min.Y;
+			endpoint.Max = onX ? max.X : max.Y;
+			maxExtent = std::max(maxExtent, endpoint.Max - endpoint.Min);
+			endpoints[count++] = endpoint;
+
+			if (i < sortedCount)
+			{
+				keptSortedCount++;
+			}
+		}
+
+		endpoints.resize(count);
+
+		// The previous order is almost right, the new colliders are sorted apart and merged to avoid a quadratic insertion sort
+		const auto middle = endpoints.begin() + static_cast<std::ptrdiff_t>(keptSortedCount);
+		const auto compare = [](const SweepEndpoint& a, const SweepEndpoint& b) { return a.Min < b.Min; };
+
+		insertionSort(endpoints, keptSortedCount);
+
+		if (middle == endpoints.end()) return;
+
+		std::sort(middle, endpoints.end(), compare);
+		std::inplace_merge(endpoints.begin(), middle, endpoints.end(), compare);
+	}
+
+	void SweepAndPrune::Update(std::span<const SimplifiedCollider> colliders) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(update, "SweepAndPrune::Update", true);
+#endif
+
+		_updateCount++;
+
+		const auto sortedCount = _endpointsX.size();
+		Math::Vec2F sum = Math::Vec2F::Zero();
+		Math::Vec2F squareSum = Math::Vec2F::Zero();
+
+		for (const auto& collider : colliders)
+		{
+			const auto index = collider.Ref.Index;
+
+			if (index >= _proxies.size())
+			{
+				_proxies.resize(index + 1);
+			}
+
+			auto& proxy = _proxies[index];
+
+			if (!proxy.InUse)
+			{
+				proxy.InUse = true;
+				_endpointsX.push_back({0.f, 0.f, index});
+				_endpointsY.push_back({0.f, 0.f, index});
+			}
+
+			proxy.Ref = collider.Ref;
+			proxy.Bounds = collider.Bounds;
+			proxy.LastUpdate = _updateCount;
+
+			const auto center = collider.Bounds.Center();
+
+			sum += center;
+			squareSum += Math::Vec2F(center.X * center.X, center.Y * center.Y);
+		}
+
+		// Removed colliders are marked as not in use by the first axis, the second one only removes their endpoints
+		updateEndpoints(_endpointsX, sortedCount, true, _maxExtentX);
+		updateEndpoints(_endpointsY, sortedCount, false, _maxExtentY);
+
+		// Sweep the axis with the highest variance, it has the fewest overlapping intervals
+		if (colliders.empty()) return;
+
+		const auto count = static_cast<float>(colliders.size());
+		const auto mean = sum / count;
+		const auto varianceX = squareSum.X / count - mean.X * mean.X;
+		const auto varianceY = squareSum.Y / count - mean.Y * mean.Y;
+
+		_sweepOnX = varianceX >= varianceY;
+	}
+
+	const MyVector<ColliderPair>& SweepAndPrune::GetAllPossiblePairs() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(GetAllPossiblePairs, "SweepAndPrune::GetAllPossiblePairs", true);
+#endif
+
+		_allPossiblePairs.clear();
+
+		const auto& endpoints = _sweepOnX ? _endpointsX : _endpointsY;
+
+		for (std::size_t i = 0; i < endpoints.size(); i++)
+		{
+			const auto& endpoint = endpoints[i];
+			const auto& proxy = _proxies[endpoint.Proxy];
+
+			// The intervals are sorted by min, stop when the next one starts after the end of this one
+			for (std::size_t j = i + 1; j < endpoints.size() && endpoints[j].Min <= endpoint.Max; j++)
+			{
+				const auto& otherProxy = _proxies[endpoints[j].Proxy];
+
+				if (Math::Intersect(proxy.Bounds, otherProxy.Bounds))
+				{
+					_allPossiblePairs.push_back(ColliderPair{proxy.Ref, otherProxy.Ref});
+				}
+			}
+		}
+
+		return _allPossiblePairs;
+	}
+
+	std::vector<Math::RectangleF> SweepAndPrune::GetBoundaries() const noexcept
+	{
+		return {};
+	}
+
+	void SweepAndPrune::Query(const Math::RectangleF& bounds, MyVector<ColliderRef>& results) const noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(query, "SweepAndPrune::Query", true);
+#endif
+
+		const auto& endpoints = _sweepOnX ? _endpointsX : _endpointsY;
+		const auto min = _sweepOnX ? bounds.MinBound().X : bounds.MinBound().Y;
+		const auto max = _sweepOnX ? bounds.MaxBound().X : bounds.MaxBound().Y;
+		const auto maxExtent = _sweepOnX ? _maxExtentX : _maxExtentY;
+
+		// The intervals that start before this one end before the bounds
+		const auto first = std::lower_bound(endpoints.begin(), endpoints.end(), min - maxExtent, [](const SweepEndpoint& endpoint, float value) {
+			return endpoint.Min < value;
+		});
+
+		for (auto i = static_cast<std::size_t>(first - endpoints.begin()); i < endpoints.size() && endpoints[i].Min <= max; i++)
+		{
+			const auto& proxy = _proxies[endpoints[i].Proxy];
+
+			if (Math::Intersect(proxy.Bounds, bounds))
+			{
+				results.push_back(proxy.Ref);
+			}
+		}
+	}
+
+	std::size_t SweepAndPrune::GetCollidersCount() const noexcept
+	{
+		return _endpointsX.size();
+	}
+}
\ No newline at end of file
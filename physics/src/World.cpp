@@ -1,7 +1,19 @@
 #include "World.h"
 
 #include "Exception.h"
-#include "ContactResolver.h"
+#include "QuadTree.h"
+#include "LinearQuadTree.h"
+#include "SweepAndPrune.h"
+#include "DynamicTree.h"
+#include "SpatialHash.h"
+
+#include "Intrinsics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
 
 #ifdef TRACY_ENABLE
 #include <tracy/Tracy.hpp>
@@ -11,56 +23,100 @@
 namespace Physics
 {
 	World::World(std::size_t defaultBodySize) noexcept :
-		_lastColliderPairs{StandardAllocator<ColliderPair> {_heapAllocator} },
+		_broadPhase { new QuadTree(Math::RectangleF(Math::Vec2F::Zero(), Math::Vec2F::One())) },
+		_bodyStorage { new BodyStorage(_heapAllocator) },
+		_shapeStorage { new ShapeStorage(_heapAllocator) },
+		_broadPhaseColliders { StandardAllocator<SimplifiedCollider> {_heapAllocator} },
+		_queryCandidates { StandardAllocator<ColliderRef> {_heapAllocator} },
+		_colliderPairs { StandardAllocator<ColliderPair> {_heapAllocator} },
+		_lastColliderPairs { StandardAllocator<ColliderPair> {_heapAllocator} },
 		_bodies { StandardAllocator<Body> {_heapAllocator} },
 		_colliders { StandardAllocator<Collider> {_heapAllocator} },
 		_colliderGenerations { StandardAllocator<std::size_t> {_heapAllocator} },
-		_bodyGenerations { StandardAllocator<std::size_t> {_heapAllocator} }
+		_bodyGenerations { StandardAllocator<std::size_t> {_heapAllocator} },
+		_freeBodies { StandardAllocator<std::size_t> {_heapAllocator} },
+		_freeColliders { StandardAllocator<std::size_t> {_heapAllocator} },
+		_bodyColliders { StandardAllocator<std::size_t> {_heapAllocator} },
+		_colliderLinks { StandardAllocator<ColliderLink> {_heapAllocator} },
+		_bulletPairs { StandardAllocator<ColliderPair> {_heapAllocator} },
+		_contactPairs { StandardAllocator<ColliderPair> {_heapAllocator} },
+		_islandParents { StandardAllocator<std::size_t> {_heapAllocator} },
+		_bodyIslands { StandardAllocator<std::size_t> {_heapAllocator} },
+		_contactResolvers { StandardAllocator<ContactResolver> {_heapAllocator} },
+		_warmImpulses { StandardAllocator<float> {_heapAllocator} },
+		_persistentContacts { StandardAllocator<PersistentContact> {_heapAllocator} },
+		_islandContacts { StandardAllocator<std::size_t> {_heapAllocator} },
+		_islandOffsets { StandardAllocator<std::size_t> {_heapAllocator} },
+		_timeOfImpacts { StandardAllocator<TimeOfImpact> {_heapAllocator} },
+		_contactEvents { _heapAllocator }
 	{
 		if (defaultBodySize == 0)
 		{
 			defaultBodySize = 1;
 		}
 
-		_bodies.resize(defaultBodySize);
-		_bodyGenerations.resize(defaultBodySize, 0);
-		_colliders.resize(defaultBodySize);
-		_colliderGenerations.resize(defaultBodySize, 0);
+		resizeBodies(defaultBodySize);
+		resizeColliders(defaultBodySize);
 	}
 
-	void World::updateColliders() noexcept
+	void World::resizeBodies(std::size_t newSize) noexcept
 	{
-#ifdef TRACY_ENABLE
-		ZoneNamedN(updateColliders, "World::updateColliders", true);
-#endif
-		// Calculate minimum and maximum bounds of all colliders
-		float minX = std::numeric_limits<float>::max();
-		float minY = std::numeric_limits<float>::max();
-		float maxX = std::numeric_limits<float>::min();
-		float maxY = std::numeric_limits<float>::min();
+		const auto oldSize = _bodies.size();
 
-		for (auto& collider : _colliders)
+		_bodyStorage->Resize(newSize);
+		_bodies.resize(newSize);
+		_bodyGenerations.resize(newSize, 0);
+		_bodyColliders.resize(newSize, _noCollider);
+
+		// Pushed from the end to use the lowest index first
+		for (auto i = newSize; i > oldSize; i--)
 		{
-			if (!collider.IsEnabled() || collider.IsFree()) continue;
+			_bodies[i - 1] = Body(_bodyStorage.Get(), i - 1);
+			_freeBodies.push_back(i - 1);
+		}
+	}
+
+	void World::resizeColliders(std::size_t newSize) noexcept
+	{
+		const auto oldSize = _colliders.size();
 
-			const auto& bounds = collider.GetBounds();
+		_colliders.resize(newSize);
+		_colliderGenerations.resize(newSize, 0);
+		_colliderLinks.resize(newSize, ColliderLink{_noCollider, _noCollider});
 
-			const auto& min = bounds.MinBound();
-			const auto& max = bounds.MaxBound();
+		for (auto i = newSize; i > oldSize; i--)
+		{
+			_colliders[i - 1] = Collider(_shapeStorage.Get());
+			_freeColliders.push_back(i - 1);
+		}
+	}
 
-			if (min.X < minX) minX = min.X;
-			if (min.Y < minY) minY = min.Y;
-			if (max.X > maxX) maxX = max.X;
-			if (max.Y > maxY) maxY = max.Y;
+	std::size_t World::parallelFor(std::size_t count, std::size_t itemsPerTask, const std::function<void(std::size_t, std::size_t, std::size_t)>& job) noexcept
+	{
+		if (_threadPool.Get() == nullptr || count <= itemsPerTask)
+		{
+			job(0, 0, count);
+
+			return 1;
 		}
 
-		// Clear all colliders from the quadtree
-		_quadTree.ClearColliders();
+		const auto taskCount = (count + itemsPerTask - 1) / itemsPerTask;
+
+		_threadPool->ParallelFor(taskCount, [&job, count, itemsPerTask](std::size_t i) {
+			const auto begin = i * itemsPerTask;
 
-		// Update the boundary of the quadtree
-		_quadTree.UpdateBoundary(Math::RectangleF({ minX, minY }, { maxX, maxY }));
+			job(i, begin, std::min(begin + itemsPerTask, count));
+		});
 
-		// Insert all colliders into the quadtree
+		return taskCount;
+	}
+
+	void World::updateColliders() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(updateColliders, "World::updateColliders", true);
+#endif
+		// Give all colliders to the broad phase
 		insertColliders();
 
 		// Check for collisions and triggers
@@ -73,145 +129,830 @@ namespace Physics
 		ZoneNamedN(insertColliders, "World::insertColliders", true);
 #endif
 
-		for (auto& collider : _colliders)
+		const auto taskCount = (_colliders.size() + _collidersPerTask - 1) / _collidersPerTask;
+
+		while (_taskColliders.size() < std::max<std::size_t>(taskCount, 1))
 		{
-			if (!collider.IsEnabled() || collider.IsFree()) continue;
+			_taskColliders.emplace_back(StandardAllocator<SimplifiedCollider> {_heapAllocator});
+		}
+
+		const auto usedTaskCount = parallelFor(_colliders.size(), _collidersPerTask, [this](std::size_t task, std::size_t begin, std::size_t end) {
+			auto& colliders = _taskColliders[task];
+
+			colliders.clear();
+
+			for (auto i = begin; i < end; i++)
+			{
+				const auto& collider = _colliders[i];
 
-			_quadTree.Insert({collider.GetColliderRef(), collider.GetBounds()});
+				if (!collider.IsEnabled() || collider.IsFree()) continue;
+
+				const auto bodyIndex = collider.GetBodyRef().Index;
+				auto bounds = collider.GetBounds();
+
+				// The bounds of a bullet cover its whole move of this update, to find the colliders it passed through
+				if (_bodyStorage->BulletCount != 0 && _bodyStorage->Bullets[bodyIndex] != 0)
+				{
+					const auto move = _bodies[bodyIndex].Velocity() * _deltaTime;
+					const auto start = bounds + -move;
+
+					bounds = Math::RectangleF(
+						Math::Vec2F(std::min(bounds.MinBound().X, start.MinBound().X), std::min(bounds.MinBound().Y, start.MinBound().Y)),
+						Math::Vec2F(std::max(bounds.MaxBound().X, start.MaxBound().X), std::max(bounds.MaxBound().Y, start.MaxBound().Y))
+					);
+				}
+
+				colliders.push_back({collider.GetColliderRef(), bounds});
+			}
+		});
+
+		_broadPhaseColliders.clear();
+
+		for (std::size_t i = 0; i < usedTaskCount; i++)
+		{
+			_broadPhaseColliders.insert(_broadPhaseColliders.end(), _taskColliders[i].begin(), _taskColliders[i].end());
 		}
+
+		_broadPhase->Update(_broadPhaseColliders);
 	}
 
-    MyVector<ColliderPair> World::getColliderPairs() noexcept
+    void World::findColliderPairs() noexcept
     {
 #ifdef TRACY_ENABLE
-        ZoneScopedN("World::getColliderPairs");
+        ZoneScopedN("World::findColliderPairs");
 #endif
 
-        const auto& allPossibleColliderPairs = _quadTree.GetAllPossiblePairs();
-        MyVector<ColliderPair> newColliderPairs { StandardAllocator<ColliderPair> {_heapAllocator} };
+        const auto& allPossibleColliderPairs = _broadPhase->GetAllPossiblePairs();
+        const auto taskCount = (allPossibleColliderPairs.size() + _pairsPerTask - 1) / _pairsPerTask;
 
-        newColliderPairs.reserve(allPossibleColliderPairs.size());
+        while (_taskPairs.size() < std::max<std::size_t>(taskCount, 1))
+        {
+            _taskPairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+            _taskCirclePairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+            _taskCircleRectanglePairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+            _taskBulletPairs.emplace_back(StandardAllocator<ColliderPair> {_heapAllocator});
+        }
+
+        // Only the overlap checks run in parallel, the contacts are resolved in order afterwards
+        const auto usedTaskCount = parallelFor(allPossibleColliderPairs.size(), _pairsPerTask, [this, &allPossibleColliderPairs](std::size_t task, std::size_t begin, std::size_t end) {
+            auto& pairs = _taskPairs[task];
+            auto& circlePairs = _taskCirclePairs[task];
+            auto& circleRectanglePairs = _taskCircleRectanglePairs[task];
+            auto& bulletPairs = _taskBulletPairs[task];
+
+            pairs.clear();
+            circlePairs.clear();
+            circleRectanglePairs.clear();
+            bulletPairs.clear();
+
+            for (auto i = begin; i < end; i++)
+            {
+                const auto& colliderPair = allPossibleColliderPairs[i];
+                const Collider& colliderA = _colliders[colliderPair.A.Index];
+                const Collider& colliderB = _colliders[colliderPair.B.Index];
+
+                if (colliderA.GetBodyRef() == colliderB.GetBodyRef()) continue;
+
+                // The bullets are moved back to their impact before their pairs are checked
+                if (_bodyStorage->BulletCount != 0 && (_bodyStorage->Bullets[colliderA.GetBodyRef().Index] != 0 || _bodyStorage->Bullets[colliderB.GetBodyRef().Index] != 0))
+                {
+                    bulletPairs.push_back(colliderPair);
+                    continue;
+                }
+
+                addPossiblePair(colliderPair, pairs, circlePairs, circleRectanglePairs);
+            }
+
+            // The pairs are sorted by key afterwards, the order in which the batches add them does not matter
+            overlapCircles(circlePairs, pairs);
+            overlapCircleRectangles(circleRectanglePairs, pairs);
+        });
+
+        _colliderPairs.clear();
+
+        for (std::size_t i = 0; i < usedTaskCount; i++)
+        {
+            _colliderPairs.insert(_colliderPairs.end(), _taskPairs[i].begin(), _taskPairs[i].end());
+        }
 
-        for (const auto& colliderPair : allPossibleColliderPairs)
+        if (_bodyStorage->BulletCount != 0)
         {
-            const Collider& colliderA = GetCollider(colliderPair.A);
-            const Collider& colliderB = GetCollider(colliderPair.B);
+            _bulletPairs.clear();
+
+            for (std::size_t i = 0; i < usedTaskCount; i++)
+            {
+                _bulletPairs.insert(_bulletPairs.end(), _taskBulletPairs[i].begin(), _taskBulletPairs[i].end());
+            }
+
+            solveTimeOfImpacts(_bulletPairs);
+
+            // The batches of the first task are done, they are reused for the few pairs of the bullets
+            auto& circlePairs = _taskCirclePairs[0];
+            auto& circleRectanglePairs = _taskCircleRectanglePairs[0];
 
-            if (colliderA.GetBodyRef() == colliderB.GetBodyRef()) continue;
+            circlePairs.clear();
+            circleRectanglePairs.clear();
 
-            if (colliderA.GetShapeType() == Math::ShapeType::Rectangle && colliderB.GetShapeType() == Math::ShapeType::Rectangle ||
-                overlap(colliderA, colliderB))
+            for (const auto& colliderPair : _bulletPairs)
             {
-                newColliderPairs.push_back(colliderPair);
+                addPossiblePair(colliderPair, _colliderPairs, circlePairs, circleRectanglePairs);
             }
+
+            overlapCircles(circlePairs, _colliderPairs);
+            overlapCircleRectangles(circleRectanglePairs, _colliderPairs);
         }
 
+        std::sort(_colliderPairs.begin(), _colliderPairs.end(), [](const ColliderPair& a, const ColliderPair& b) {
+            return getPairKey(a) < getPairKey(b);
+        });
+
 #ifdef TRACY_ENABLE
 
         const auto& info = fmt::format(
                 "{} - {} = {} verified collider pairs",
-                allPossibleColliderPairs.size(), allPossibleColliderPairs.size() - newColliderPairs.size(), newColliderPairs.size());
+                allPossibleColliderPairs.size(), allPossibleColliderPairs.size() - _colliderPairs.size(), _colliderPairs.size());
         ZoneText(info.c_str(), info.size());
 #endif
-
-        return newColliderPairs;
     }
 
+	void World::addPossiblePair(const ColliderPair& colliderPair, MyVector<ColliderPair>& pairs, MyVector<ColliderPair>& circlePairs, MyVector<ColliderPair>& circleRectanglePairs) const noexcept
+	{
+		const Collider& colliderA = _colliders[colliderPair.A.Index];
+		const Collider& colliderB = _colliders[colliderPair.B.Index];
+		const auto sortedPair = colliderPair.A.Index < colliderPair.B.Index ? colliderPair : ColliderPair{colliderPair.B, colliderPair.A};
+		const auto bodyA = colliderA.GetBodyRef().Index;
+		const auto bodyB = colliderB.GetBodyRef().Index;
+
+		// The colliders of resting bodies have not moved since the last update, the pair overlaps if it did then.
+		// A static body moved or given a collider by the user is checked again.
+		if (isResting(bodyA) && isResting(bodyB) && (_bodyStorage->AwakeScales[bodyA] == 0.f || _bodyStorage->AwakeScales[bodyB] == 0.f) &&
+			_bodyStorage->Changed[bodyA] == 0 && _bodyStorage->Changed[bodyB] == 0)
+		{
+			if (wasColliding(sortedPair))
+			{
+				pairs.push_back(sortedPair);
+			}
+
+			return;
+		}
+
+		const auto shapeA = colliderA.GetShapeType();
+		const auto shapeB = colliderB.GetShapeType();
+
+		if (shapeA == Math::ShapeType::Rectangle && shapeB == Math::ShapeType::Rectangle)
+		{
+			pairs.push_back(sortedPair);
+		}
+		else if (shapeA == Math::ShapeType::Circle && shapeB == Math::ShapeType::Circle)
+		{
+			circlePairs.push_back(sortedPair);
+		}
+		else if (shapeA == Math::ShapeType::Circle && shapeB == Math::ShapeType::Rectangle)
+		{
+			circleRectanglePairs.push_back(colliderPair);
+		}
+		else if (shapeA == Math::ShapeType::Rectangle && shapeB == Math::ShapeType::Circle)
+		{
+			circleRectanglePairs.push_back(ColliderPair{colliderPair.B, colliderPair.A});
+		}
+		else if (overlap(colliderA, colliderB))
+		{
+			pairs.push_back(sortedPair);
+		}
+	}
+
+	void World::overlapCircles(const MyVector<ColliderPair>& circlePairs, MyVector<ColliderPair>& pairs) const noexcept
+	{
+		std::size_t i = 0;
+
+#ifdef __AVX__
+		// The last batch is padded with empty lanes that are masked out, so all the pairs go through the same checks
+		for (; i < circlePairs.size(); i += 8)
+		{
+			const auto count = std::min<std::size_t>(8, circlePairs.size() - i);
+			std::array<float, 8> centersX {};
+			std::array<float, 8> centersY {};
+			std::array<float, 8> radii {};
+
+			for (std::size_t lane = 0; lane < count; lane++)
+			{
+				const auto& circleA = _colliders[circlePairs[i + lane].A.Index].GetWorldCircle();
+				const auto& circleB = _colliders[circlePairs[i + lane].B.Index].GetWorldCircle();
+				const auto distance = circleA.Center() - circleB.Center();
+
+				centersX[lane] = distance.X;
+				centersY[lane] = distance.Y;
+				radii[lane] = circleA.Radius() + circleB.Radius();
+			}
+
+			const auto distanceX = _mm256_loadu_ps(centersX.data());
+			const auto distanceY = _mm256_loadu_ps(centersY.data());
+			const auto radius = _mm256_loadu_ps(radii.data());
+			const auto squareDistance = _mm256_add_ps(_mm256_mul_ps(distanceX, distanceX), _mm256_mul_ps(distanceY, distanceY));
+			const auto mask = _mm256_movemask_ps(_mm256_cmp_ps(squareDistance, _mm256_mul_ps(radius, radius), _CMP_LE_OQ)) & ((1 << count) - 1);
+
+			for (std::size_t lane = 0; lane < count; lane++)
+			{
+				if ((mask >> lane & 1) == 0) continue;
+
+				pairs.push_back(circlePairs[i + lane]);
+			}
+		}
+#endif
+
+		for (; i < circlePairs.size(); i++)
+		{
+			const auto& circlePair = circlePairs[i];
+
+			if (Math::Intersect(_colliders[circlePair.A.Index].GetWorldCircle(), _colliders[circlePair.B.Index].GetWorldCircle()))
+			{
+				pairs.push_back(circlePair);
+			}
+		}
+	}
+
+	void World::overlapCircleRectangles(const MyVector<ColliderPair>& circleRectanglePairs, MyVector<ColliderPair>& pairs) const noexcept
+	{
+		std::size_t i = 0;
+
+#ifdef __AVX__
+		for (; i < circleRectanglePairs.size(); i += 8)
+		{
+			const auto count = std::min<std::size_t>(8, circleRectanglePairs.size() - i);
+			std::array<float, 8> centersX {};
+			std::array<float, 8> centersY {};
+			std::array<float, 8> radii {};
+			std::array<float, 8> minX {};
+			std::array<float, 8> minY {};
+			std::array<float, 8> maxX {};
+			std::array<float, 8> maxY {};
+
+			for (std::size_t lane = 0; lane < count; lane++)
+			{
+				const auto& circle = _colliders[circleRectanglePairs[i + lane].A.Index].GetWorldCircle();
+				const auto& rectangle = _colliders[circleRectanglePairs[i + lane].B.Index].GetWorldRectangle();
+
+				centersX[lane] = circle.Center().X;
+				centersY[lane] = circle.Center().Y;
+				radii[lane] = circle.Radius();
+				minX[lane] = rectangle.MinBound().X;
+				minY[lane] = rectangle.MinBound().Y;
+				maxX[lane] = rectangle.MaxBound().X;
+				maxY[lane] = rectangle.MaxBound().Y;
+			}
+
+			const auto centerX = _mm256_loadu_ps(centersX.data());
+			const auto centerY = _mm256_loadu_ps(centersY.data());
+			const auto radius = _mm256_loadu_ps(radii.data());
+			const auto min8X = _mm256_loadu_ps(minX.data());
+			const auto min8Y = _mm256_loadu_ps(minY.data());
+			const auto max8X = _mm256_loadu_ps(maxX.data());
+			const auto max8Y = _mm256_loadu_ps(maxY.data());
+			const auto squareRadius = _mm256_mul_ps(radius, radius);
+
+			// The center is in the rectangle grown by the radius on one of the axes, which contains the rectangle itself
+			const auto insideX = _mm256_and_ps(_mm256_cmp_ps(centerY, min8Y, _CMP_GE_OQ), _mm256_cmp_ps(centerY, max8Y, _CMP_LE_OQ));
+			const auto insideY = _mm256_and_ps(_mm256_cmp_ps(centerX, min8X, _CMP_GE_OQ), _mm256_cmp_ps(centerX, max8X, _CMP_LE_OQ));
+			const auto grownX = _mm256_and_ps(insideX, _mm256_and_ps(
+				_mm256_cmp_ps(centerX, _mm256_sub_ps(min8X, radius), _CMP_GE_OQ),
+				_mm256_cmp_ps(centerX, _mm256_add_ps(max8X, radius), _CMP_LE_OQ)));
+			const auto grownY = _mm256_and_ps(insideY, _mm256_and_ps(
+				_mm256_cmp_ps(centerY, _mm256_sub_ps(min8Y, radius), _CMP_GE_OQ),
+				_mm256_cmp_ps(centerY, _mm256_add_ps(max8Y, radius), _CMP_LE_OQ)));
+
+			// Or one of the corners is in the circle
+			const auto toMinX = _mm256_sub_ps(centerX, min8X);
+			const auto toMinY = _mm256_sub_ps(centerY, min8Y);
+			const auto toMaxX = _mm256_sub_ps(centerX, max8X);
+			const auto toMaxY = _mm256_sub_ps(centerY, max8Y);
+			const auto squareMinX = _mm256_mul_ps(toMinX, toMinX);
+			const auto squareMinY = _mm256_mul_ps(toMinY, toMinY);
+			const auto squareMaxX = _mm256_mul_ps(toMaxX, toMaxX);
+			const auto squareMaxY = _mm256_mul_ps(toMaxY, toMaxY);
+			const auto corners = _mm256_or_ps(
+				_mm256_or_ps(
+					_mm256_cmp_ps(_mm256_add_ps(squareMinX, squareMinY), squareRadius, _CMP_LE_OQ),
+					_mm256_cmp_ps(_mm256_add_ps(squareMaxX, squareMaxY), squareRadius, _CMP_LE_OQ)),
+				_mm256_or_ps(
+					_mm256_cmp_ps(_mm256_add_ps(squareMinX, squareMaxY), squareRadius, _CMP_LE_OQ),
+					_mm256_cmp_ps(_mm256_add_ps(squareMaxX, squareMinY), squareRadius, _CMP_LE_OQ)));
+
+			const auto mask = _mm256_movemask_ps(_mm256_or_ps(_mm256_or_ps(grownX, grownY), corners)) & ((1 << count) - 1);
+
+			for (std::size_t lane = 0; lane < count; lane++)
+			{
+				if ((mask >> lane & 1) == 0) continue;
+
+				const auto& circleRectanglePair = circleRectanglePairs[i + lane];
+
+				pairs.push_back(circleRectanglePair.A.Index < circleRectanglePair.B.Index ?
+					circleRectanglePair : ColliderPair{circleRectanglePair.B, circleRectanglePair.A});
+			}
+		}
+#endif
+
+		for (; i < circleRectanglePairs.size(); i++)
+		{
+			const auto& circleRectanglePair = circleRectanglePairs[i];
+
+			if (Math::Intersect(_colliders[circleRectanglePair.A.Index].GetWorldCircle(), _colliders[circleRectanglePair.B.Index].GetWorldRectangle()))
+			{
+				pairs.push_back(circleRectanglePair.A.Index < circleRectanglePair.B.Index ?
+					circleRectanglePair : ColliderPair{circleRectanglePair.B, circleRectanglePair.A});
+			}
+		}
+	}
+
 	void World::processColliders() noexcept
 	{
 #ifdef TRACY_ENABLE
         ZoneScopedN("World::processColliders");
 #endif
-		MyVector<ColliderPair> newColliderPairs = getColliderPairs();
+		findColliderPairs();
 
 #ifdef TRACY_ENABLE
         ZoneNamedN(onCollisions, "Check triggers and collisions", true);
 #endif
 
-		for (const auto& collider : newColliderPairs)
-		{
-			const Collider& colliderA = GetCollider(collider.A);
-			const Collider& colliderB = GetCollider(collider.B);
+		_contactPairs.clear();
 
-			if (std::find(_lastColliderPairs.begin(), _lastColliderPairs.end(), collider) == _lastColliderPairs.end())
-			{
-				if (_contactListener == nullptr) continue;
+		// Both lists are sorted by key, a pair only in the new list enters, only in the last list exits and in both stays
+		std::size_t i = 0;
+		std::size_t j = 0;
 
-				// Enter
-				if (colliderA.IsTrigger() || colliderB.IsTrigger())
+		while (i < _colliderPairs.size() || j < _lastColliderPairs.size())
+		{
+			if (j == _lastColliderPairs.size() || (i < _colliderPairs.size() && getPairKey(_colliderPairs[i]) < getPairKey(_lastColliderPairs[j])))
+			{
+				onContactEnter(_colliderPairs[i++]);
+			}
+			else if (i == _colliderPairs.size() || getPairKey(_colliderPairs[i]) > getPairKey(_lastColliderPairs[j]))
+			{
+				onContactExit(_lastColliderPairs[j++]);
+			}
+			else
+			{
+				// A collider destroyed and created again at the same index is a new contact
+				if (_colliderPairs[i].A == _lastColliderPairs[j].A && _colliderPairs[i].B == _lastColliderPairs[j].B)
 				{
-					_contactListener->OnTriggerEnter(collider.A, collider.B);
+					onContactStay(_colliderPairs[i]);
 				}
 				else
 				{
-					_contactListener->OnCollisionEnter(collider.A, collider.B);
+					onContactExit(_lastColliderPairs[j]);
+					onContactEnter(_colliderPairs[i]);
 				}
+
+				i++;
+				j++;
+			}
+		}
+
+		std::swap(_colliderPairs, _lastColliderPairs);
+
+		solveIslands();
+	}
+
+	void World::onContactEnter(const ColliderPair& colliderPair) noexcept
+	{
+		// A sleeping body only gets a new contact when a static body is moved into it
+		wakeUp(colliderPair);
+
+		if (_contactListener == nullptr && !_contactEventTypes.Enter) return;
+
+		const Collider& colliderA = GetCollider(colliderPair.A);
+		const Collider& colliderB = GetCollider(colliderPair.B);
+		const auto isTrigger = colliderA.IsTrigger() || colliderB.IsTrigger();
+
+		if (_contactEventTypes.Enter)
+		{
+			(isTrigger ? _contactEvents.TriggerEnters : _contactEvents.CollisionEnters).push_back(colliderPair);
+		}
+
+		if (_contactListener == nullptr) return;
+
+		if (isTrigger)
+		{
+			_contactListener->OnTriggerEnter(colliderPair.A, colliderPair.B);
+		}
+		else
+		{
+			_contactListener->OnCollisionEnter(colliderPair.A, colliderPair.B);
+		}
+	}
+
+	void World::onContactStay(const ColliderPair& colliderPair) noexcept
+	{
+		const Collider& colliderA = GetCollider(colliderPair.A);
+		const Collider& colliderB = GetCollider(colliderPair.B);
+
+		if (colliderA.IsTrigger() || colliderB.IsTrigger())
+		{
+			if (_contactEventTypes.Stay)
+			{
+				_contactEvents.TriggerStays.push_back(colliderPair);
+			}
+
+			if (_contactListener == nullptr) return;
+
+			_contactListener->OnTriggerStay(colliderPair.A, colliderPair.B);
+
+			return;
+		}
+
+		if (_contactEventTypes.Stay)
+		{
+			_contactEvents.CollisionStays.push_back(colliderPair);
+		}
+
+		if (_contactListener != nullptr)
+		{
+			_contactListener->OnCollisionStay(colliderPair.A, colliderPair.B);
+		}
+
+		auto& bodyA = GetBody(colliderA.GetBodyRef());
+		auto& bodyB = GetBody(colliderB.GetBodyRef());
+		const auto restingA = isResting(colliderA.GetBodyRef().Index);
+		const auto restingB = isResting(colliderB.GetBodyRef().Index);
+
+		// Two resting bodies stay as they are, a moving body wakes up the sleeping one it touches
+		if (restingA && restingB) return;
+
+		if (restingA && bodyA.GetBodyType() == BodyType::Dynamic)
+		{
+			bodyA.WakeUp();
+		}
+
+		if (restingB && bodyB.GetBodyType() == BodyType::Dynamic)
+		{
+			bodyB.WakeUp();
+		}
+
+		if (bodyA.GetBodyType() == BodyType::Dynamic || bodyB.GetBodyType() == BodyType::Dynamic)
+		{
+			_contactPairs.push_back(colliderPair);
+		}
+	}
+
+	void World::onContactExit(const ColliderPair& colliderPair) noexcept
+	{
+		// The bodies resting on a collider that moved away or was destroyed fall again
+		wakeUp(colliderPair);
+
+		if (_contactListener == nullptr && !_contactEventTypes.Exit) return;
+
+		if (_colliderGenerations[colliderPair.A.Index] != colliderPair.A.Generation ||
+			_colliderGenerations[colliderPair.B.Index] != colliderPair.B.Generation) return;
+
+		const Collider& colliderA = GetCollider(colliderPair.A);
+		const Collider& colliderB = GetCollider(colliderPair.B);
+		const auto isTrigger = colliderA.IsTrigger() || colliderB.IsTrigger();
+
+		if (_contactEventTypes.Exit)
+		{
+			(isTrigger ? _contactEvents.TriggerExits : _contactEvents.CollisionExits).push_back(colliderPair);
+		}
+
+		if (_contactListener == nullptr) return;
+
+		if (isTrigger)
+		{
+			_contactListener->OnTriggerExit(colliderPair.A, colliderPair.B);
+		}
+		else
+		{
+			_contactListener->OnCollisionExit(colliderPair.A, colliderPair.B);
+		}
+	}
+
+	void World::wakeUp(const ColliderPair& colliderPair) noexcept
+	{
+		for (const auto& colliderRef : {colliderPair.A, colliderPair.B})
+		{
+			if (_colliderGenerations[colliderRef.Index] != colliderRef.Generation) continue;
+
+			auto& body = _bodies[_colliders[colliderRef.Index].GetBodyRef().Index];
+
+			if (body.GetBodyType() == BodyType::Dynamic)
+			{
+				body.WakeUp();
+			}
+		}
+	}
+
+	bool World::wasColliding(const ColliderPair& colliderPair) const noexcept
+	{
+		const auto key = getPairKey(colliderPair);
+		const auto it = std::lower_bound(_lastColliderPairs.begin(), _lastColliderPairs.end(), key, [](const ColliderPair& pair, std::uint64_t value) {
+			return getPairKey(pair) < value;
+		});
+
+		return it != _lastColliderPairs.end() && it->A == colliderPair.A && it->B == colliderPair.B;
+	}
+
+	std::uint64_t World::getPairKey(const ColliderPair& colliderPair) noexcept
+	{
+		return static_cast<std::uint64_t>(colliderPair.A.Index) << 32 | static_cast<std::uint64_t>(colliderPair.B.Index);
+	}
+
+	std::size_t World::findIsland(std::size_t bodyIndex) noexcept
+	{
+		while (_islandParents[bodyIndex] != bodyIndex)
+		{
+			_islandParents[bodyIndex] = _islandParents[_islandParents[bodyIndex]];
+			bodyIndex = _islandParents[bodyIndex];
+		}
+
+		return bodyIndex;
+	}
+
+	void World::buildIslands() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(buildIslands, "World::buildIslands", true);
+#endif
+
+		const auto& types = _bodyStorage->Types;
+
+		_islandParents.resize(_bodies.size());
+		std::iota(_islandParents.begin(), _islandParents.end(), std::size_t {0});
+
+		for (const auto& contactPair : _contactPairs)
+		{
+			const auto bodyA = _colliders[contactPair.A.Index].GetBodyRef().Index;
+			const auto bodyB = _colliders[contactPair.B.Index].GetBodyRef().Index;
+
+			if (types[bodyA] != BodyType::Dynamic || types[bodyB] != BodyType::Dynamic) continue;
+
+			const auto rootA = findIsland(bodyA);
+			const auto rootB = findIsland(bodyB);
+
+			// The lowest body is the root to give the same islands in any order
+			if (rootA < rootB)
+			{
+				_islandParents[rootB] = rootA;
 			}
 			else
 			{
-				// Stay
-				if (colliderA.IsTrigger() || colliderB.IsTrigger())
-				{
-					if (_contactListener == nullptr) continue;
+				_islandParents[rootA] = rootB;
+			}
+		}
 
-					_contactListener->OnTriggerStay(collider.A, collider.B);
-				}
-				else
+		// Number the islands in the order of their first contact and count their contacts
+		_bodyIslands.assign(_bodies.size(), _noIsland);
+		_islandOffsets.clear();
+
+		const auto getIsland = [this, &types](const ColliderPair& contactPair) {
+			const auto bodyA = _colliders[contactPair.A.Index].GetBodyRef().Index;
+			const auto bodyB = _colliders[contactPair.B.Index].GetBodyRef().Index;
+
+			return findIsland(types[bodyA] == BodyType::Dynamic ? bodyA : bodyB);
+		};
+
+		for (const auto& contactPair : _contactPairs)
+		{
+			const auto root = getIsland(contactPair);
+
+			if (_bodyIslands[root] == _noIsland)
+			{
+				_bodyIslands[root] = _islandOffsets.size();
+				_islandOffsets.push_back(0);
+			}
+
+			_islandOffsets[_bodyIslands[root]]++;
+		}
+
+		// The counts become the starts of the islands, they are moved to the ends while the contacts are placed
+		std::size_t start = 0;
+
+		for (auto& offset : _islandOffsets)
+		{
+			const auto count = offset;
+
+			offset = start;
+			start += count;
+		}
+
+		_islandContacts.resize(_contactPairs.size());
+
+		for (std::size_t i = 0; i < _contactPairs.size(); i++)
+		{
+			_islandContacts[_islandOffsets[_bodyIslands[getIsland(_contactPairs[i])]]++] = i;
+		}
+
+		_islandOffsets.insert(_islandOffsets.begin(), 0);
+	}
+
+	void World::solveIslands() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(solveIslands, "World::solveIslands", true);
+#endif
+
+		if (_contactPairs.empty())
+		{
+			_persistentContacts.clear();
+
+			return;
+		}
+
+		// Both lists are sorted by key, a contact of the last update starts from its impulse
+		_contactResolvers.clear();
+		_warmImpulses.clear();
+
+		std::size_t j = 0;
+
+		for (const auto& contactPair : _contactPairs)
+		{
+			const auto key = getPairKey(contactPair);
+			auto& colliderA = _colliders[contactPair.A.Index];
+			auto& colliderB = _colliders[contactPair.B.Index];
+
+			while (j < _persistentContacts.size() && getPairKey(_persistentContacts[j].Pair) < key)
+			{
+				j++;
+			}
+
+			const auto isPersistent = j < _persistentContacts.size() &&
+				_persistentContacts[j].Pair.A == contactPair.A && _persistentContacts[j].Pair.B == contactPair.B;
+
+			_contactResolvers.emplace_back(&_bodies[colliderA.GetBodyRef().Index], &_bodies[colliderB.GetBodyRef().Index], &colliderA, &colliderB);
+			_warmImpulses.push_back(isPersistent ? _persistentContacts[j].NormalImpulse : 0.f);
+		}
+
+		buildIslands();
+
+		const auto islandCount = _islandOffsets.size() - 1;
+		const auto solveIsland = [this](std::size_t island) {
+			const auto begin = _islandOffsets[island];
+			const auto end = _islandOffsets[island + 1];
+
+			for (auto i = begin; i < end; i++)
+			{
+				_contactResolvers[_islandContacts[i]].PrepareContact(_warmImpulses[_islandContacts[i]]);
+			}
+
+			for (std::size_t iteration = 0; iteration < _velocityIterations; iteration++)
+			{
+				for (auto i = begin; i < end; i++)
 				{
-					if (_contactListener != nullptr)
-					{
-						_contactListener->OnCollisionStay(collider.A, collider.B);
-					}
+					_contactResolvers[_islandContacts[i]].SolveVelocity();
+				}
+			}
+
+			for (auto i = begin; i < end; i++)
+			{
+				_contactResolvers[_islandContacts[i]].SolvePosition();
+			}
+		};
+
+		if (_threadPool.Get() == nullptr || islandCount == 1)
+		{
+			for (std::size_t i = 0; i < islandCount; i++)
+			{
+				solveIsland(i);
+			}
+		}
+		else
+		{
+			_threadPool->ParallelFor(islandCount, solveIsland);
+		}
+
+		_persistentContacts.clear();
+
+		for (std::size_t i = 0; i < _contactPairs.size(); i++)
+		{
+			_persistentContacts.push_back({_contactPairs[i], _contactResolvers[i].GetNormalImpulse()});
+		}
+	}
+
+	void World::solveTimeOfImpacts(const MyVector<ColliderPair>& colliderPairs) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(solveTimeOfImpacts, "World::solveTimeOfImpacts", true);
+#endif
+
+		auto& storage = *_bodyStorage;
+
+		_timeOfImpacts.clear();
+
+		for (const auto& colliderPair : colliderPairs)
+		{
+			for (const auto& [bulletRef, otherRef] : {std::pair{colliderPair.A, colliderPair.B}, std::pair{colliderPair.B, colliderPair.A}})
+			{
+				const auto& bullet = _colliders[bulletRef.Index];
+				const auto& other = _colliders[otherRef.Index];
+				const auto bodyIndex = bullet.GetBodyRef().Index;
+				const auto otherBodyIndex = other.GetBodyRef().Index;
+
+				if (storage.Bullets[bodyIndex] == 0 || storage.AwakeScales[bodyIndex] == 0.f || bodyIndex == otherBodyIndex) continue;
+				if (bullet.IsTrigger() || other.IsTrigger()) continue;
+
+				const auto& body = _bodies[bodyIndex];
+				const auto& otherBody = _bodies[otherBodyIndex];
+				const auto move = (body.Velocity() - otherBody.Velocity()) * _deltaTime;
+				const auto time = getTimeOfImpact(bullet, other, move);
+
+				if (time < 0.f) continue;
+
+				_timeOfImpacts.push_back({bodyIndex, bulletRef, otherRef, time});
+			}
+		}
+
+		std::sort(_timeOfImpacts.begin(), _timeOfImpacts.end(), [](const TimeOfImpact& a, const TimeOfImpact& b) {
+			return a.BodyIndex < b.BodyIndex || (a.BodyIndex == b.BodyIndex && a.Time < b.Time);
+		});
+
+		for (std::size_t i = 0; i < _timeOfImpacts.size(); i++)
+		{
+			const auto& impact = _timeOfImpacts[i];
+
+			// Only the first impact of each bullet is kept, the bullet does not reach the next ones
+			if (i > 0 && _timeOfImpacts[i - 1].BodyIndex == impact.BodyIndex) continue;
+
+			auto& body = _bodies[impact.BodyIndex];
+			auto& otherBody = _bodies[_colliders[impact.Other.Index].GetBodyRef().Index];
+			const auto move = (body.Velocity() - otherBody.Velocity()) * _deltaTime;
+
+			body.AddPosition(-move * (1.f - impact.Time));
+
+			for (auto colliderIndex = _bodyColliders[impact.BodyIndex]; colliderIndex != _noCollider; colliderIndex = _colliderLinks[colliderIndex].Next)
+			{
+				auto& collider = _colliders[colliderIndex];
+
+				collider.SetPosition(body.Position() + collider.GetOffset());
+			}
+
+			ContactResolver contactResolver(&body, &otherBody, &_colliders[impact.Bullet.Index], &_colliders[impact.Other.Index]);
+
+			contactResolver.PrepareContact(0.f);
+			contactResolver.SolveVelocity();
+		}
+	}
+
+	float World::getTimeOfImpact(const Collider& collider, const Collider& other, Math::Vec2F move) noexcept
+	{
+		const auto getCenter = [](const Collider& shapeCollider) {
+			return shapeCollider.GetShapeType() == Math::ShapeType::Circle ? shapeCollider.GetWorldCircle().Center() : shapeCollider.GetWorldRectangle().Center();
+		};
+		const auto getHalfSize = [](const Collider& shapeCollider) {
+			if (shapeCollider.GetShapeType() == Math::ShapeType::Circle)
+			{
+				const auto radius = shapeCollider.GetCircle().Radius();
+
+				return Math::Vec2F(radius, radius);
+			}
+
+			return shapeCollider.GetRectangle().HalfSize();
+		};
+
+		const auto type = collider.GetShapeType();
+		const auto otherType = other.GetShapeType();
+
+		if (type != Math::ShapeType::Circle && type != Math::ShapeType::Rectangle) return -1.f;
+		if (otherType != Math::ShapeType::Circle && otherType != Math::ShapeType::Rectangle) return -1.f;
+		if (move.SquareLength() == 0.f) return -1.f;
+
+		// The other collider stays at its end position and the collider moves from its start to its end
+		const auto start = getCenter(collider) - move - getCenter(other);
+
+		if (type == Math::ShapeType::Circle && otherType == Math::ShapeType::Circle)
+		{
+			// Solve |start + move * t| = radius for t
+			const auto radius = collider.GetCircle().Radius() + other.GetCircle().Radius();
+			const auto a = move.Dot(move);
+			const auto b = start.Dot(move);
+			const auto c = start.Dot(start) - radius * radius;
+			const auto discriminant = b * b - a * c;
 
-					const auto& bodyA = GetBody(colliderA.GetBodyRef());
-					const auto& bodyB = GetBody(colliderB.GetBodyRef());
+			if (c <= 0.f || discriminant < 0.f) return -1.f;
 
-					if (bodyA.GetBodyType() == BodyType::Dynamic || bodyB.GetBodyType() == BodyType::Dynamic)
-					{
-						onCollision(collider.A, collider.B);
-					}
-				}
-			}
+			const auto time = (-b - std::sqrt(discriminant)) / a;
+
+			return time >= 0.f && time <= 1.f ? time : -1.f;
 		}
 
-		if (_contactListener != nullptr)
+		// Slab test of the move against the sizes of both shapes added together around the other one
+		const auto halfSize = getHalfSize(collider) + getHalfSize(other);
+		auto near = 0.f;
+		auto far = 1.f;
+
+		for (const auto& [origin, direction, extent] : {std::tuple{start.X, move.X, halfSize.X}, std::tuple{start.Y, move.Y, halfSize.Y}})
 		{
-			// Exit
-			for (auto& colliderPair: _lastColliderPairs)
-			{
-				if (std::find(newColliderPairs.begin(), newColliderPairs.end(), colliderPair) != newColliderPairs.end()) continue;
+			if (std::abs(origin) < extent && direction == 0.f) continue;
+			if (direction == 0.f) return -1.f;
 
-				Collider& colliderA = GetCollider(colliderPair.A);
-				Collider& colliderB = GetCollider(colliderPair.B);
+			const auto toMin = (-extent - origin) / direction;
+			const auto toMax = (extent - origin) / direction;
 
-				if (colliderA.IsTrigger() || colliderB.IsTrigger())
-				{
-					_contactListener->OnTriggerExit(colliderPair.A, colliderPair.B);
-				}
-				else
-				{
-					_contactListener->OnCollisionExit(colliderPair.A, colliderPair.B);
-				}
-			}
+			near = std::max(near, std::min(toMin, toMax));
+			far = std::min(far, std::max(toMin, toMax));
 		}
 
-		_lastColliderPairs = newColliderPairs;
-	}
-
-	void World::onCollision(Physics::ColliderRef colliderRef, Physics::ColliderRef otherColliderRef) noexcept
-	{
-#ifdef TRACY_ENABLE
-		ZoneNamedN(onCollision, "World::onCollision", true);
-#endif
-
-		ContactResolver resolver(
-			&GetBody(GetCollider(colliderRef).GetBodyRef()),
-			&GetBody(GetCollider(otherColliderRef).GetBodyRef()),
-			&GetCollider(colliderRef),
-			&GetCollider(otherColliderRef)
-		);
+		// A collider that overlaps at the start is left to the contacts
+		if (near > far || (std::abs(start.X) < halfSize.X && std::abs(start.Y) < halfSize.Y)) return -1.f;
 
-		resolver.ResolveContact();
+		return near;
 	}
 
 	bool World::overlap(const Collider& colliderA, const Collider& colliderB) noexcept
@@ -222,32 +963,18 @@ namespace Physics
 
 		if (colliderA.GetBodyRef() == colliderB.GetBodyRef()) return false;
 
+        // The world shapes are moved once per update with the colliders, not for each pair
         switch (colliderA.GetShapeType())
         {
             case Math::ShapeType::Circle:
             {
-                auto circleA = Math::CircleF(colliderA.GetOffset() + colliderA.GetPosition(), colliderA.GetCircle().Radius());
+                const auto& circleA = colliderA.GetWorldCircle();
 
                 switch (colliderB.GetShapeType())
                 {
-                    case Math::ShapeType::Circle:
-                    {
-                        auto circleB = Math::CircleF(colliderB.GetOffset() + colliderB.GetPosition(), colliderB.GetCircle().Radius());
-
-                        return Math::Intersect(circleA, circleB);
-                    }
-                    case Math::ShapeType::Rectangle:
-                    {
-                        auto rectB = colliderB.GetRectangle() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(circleA, rectB);
-                    }
-                    case Math::ShapeType::Polygon:
-                    {
-                        auto polyB = colliderB.GetPolygon() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(circleA, polyB);
-                    }
+                    case Math::ShapeType::Circle: return Math::Intersect(circleA, colliderB.GetWorldCircle());
+                    case Math::ShapeType::Rectangle: return Math::Intersect(circleA, colliderB.GetWorldRectangle());
+                    case Math::ShapeType::Polygon: return Math::Intersect(circleA, colliderB.GetWorldPolygon());
 	                case Math::ShapeType::None:break;
                 }
             }
@@ -255,28 +982,13 @@ namespace Physics
 
             case Math::ShapeType::Rectangle:
             {
-                auto rectA = colliderA.GetRectangle() + colliderA.GetPosition() + colliderA.GetOffset();
+                const auto& rectA = colliderA.GetWorldRectangle();
 
                 switch (colliderB.GetShapeType())
                 {
-                    case Math::ShapeType::Circle:
-                    {
-                        auto circleB = Math::CircleF(colliderB.GetOffset() + colliderB.GetPosition(), colliderB.GetCircle().Radius());
-
-                        return Math::Intersect(rectA, circleB);
-                    }
-                    case Math::ShapeType::Rectangle:
-                    {
-                        auto rectB = colliderB.GetRectangle() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(rectA, rectB);
-                    }
-                    case Math::ShapeType::Polygon:
-                    {
-                        auto polyB = colliderB.GetPolygon() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(rectA, polyB);
-                    }
+                    case Math::ShapeType::Circle: return Math::Intersect(rectA, colliderB.GetWorldCircle());
+                    case Math::ShapeType::Rectangle: return Math::Intersect(rectA, colliderB.GetWorldRectangle());
+                    case Math::ShapeType::Polygon: return Math::Intersect(rectA, colliderB.GetWorldPolygon());
 	                case Math::ShapeType::None:break;
                 }
             }
@@ -284,28 +996,13 @@ namespace Physics
 
             case Math::ShapeType::Polygon:
             {
-                auto polyA = colliderA.GetPolygon() + colliderA.GetPosition();
+                const auto& polyA = colliderA.GetWorldPolygon();
 
                 switch (colliderB.GetShapeType())
                 {
-                    case Math::ShapeType::Circle:
-                    {
-                        auto circleB = Math::CircleF(colliderB.GetOffset() + colliderB.GetPosition(), colliderB.GetCircle().Radius());
-
-                        return Math::Intersect(polyA, circleB);
-                    }
-                    case Math::ShapeType::Rectangle:
-                    {
-                        auto rectB = colliderB.GetRectangle() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(polyA, rectB);
-                    }
-                    case Math::ShapeType::Polygon:
-                    {
-                        auto polyB = colliderB.GetPolygon() + colliderB.GetPosition() + colliderB.GetOffset();
-
-                        return Math::Intersect(polyA, polyB);
-                    }
+                    case Math::ShapeType::Circle: return Math::Intersect(polyA, colliderB.GetWorldCircle());
+                    case Math::ShapeType::Rectangle: return Math::Intersect(polyA, colliderB.GetWorldRectangle());
+                    case Math::ShapeType::Polygon: return Math::Intersect(polyA, colliderB.GetWorldPolygon());
 	                case Math::ShapeType::None:break;
                 }
             }
@@ -321,73 +1018,233 @@ namespace Physics
 #ifdef TRACY_ENABLE
 		ZoneNamedN(updateBodies, "World::updateBodies", true);
 #endif
-		for (auto& body : _bodies)
-		{
-			if (!body.IsEnabled()) continue;
+		parallelFor(_bodyStorage->PositionsX.size(), _bodiesPerTask, [this, deltaTime](std::size_t, std::size_t begin, std::size_t end) {
+			integrateBodies(begin, end, deltaTime);
+		});
 
-			switch(body.GetBodyType())
-			{
-				case BodyType::Static: break;
-				case BodyType::Dynamic:
-				{
-					if (body.UseGravity())
-					{
-						body.AddForce(_gravity);
-					}
+		parallelFor(_colliders.size(), _collidersPerTask, [this](std::size_t, std::size_t begin, std::size_t end) {
+			syncColliders(begin, end);
+		});
+	}
 
-					body.AddVelocity(body.Force() * body.InverseMass() * deltaTime);
-					body.AddPosition(body.Velocity() * deltaTime);
-					body.SetForce(Math::Vec2F(0, 0));
-				}
-				break;
-				case BodyType::Kinematic:
-				{
-					body.AddPosition(body.Velocity() * deltaTime);
-				}
-				break;
-			}
+	void World::integrateBodies(std::size_t begin, std::size_t end, float deltaTime) noexcept
+	{
+		auto& storage = *_bodyStorage;
+		auto i = begin;
+
+#ifdef __AVX__
+		const auto deltaTime8 = _mm256_set1_ps(deltaTime);
+		const auto gravityX8 = _mm256_set1_ps(_gravity.X);
+		const auto gravityY8 = _mm256_set1_ps(_gravity.Y);
+
+		for (; i + 8 <= end; i += 8)
+		{
+			const auto gravityScale = _mm256_loadu_ps(storage.GravityScales.data() + i);
+			const auto acceleration = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(storage.InverseMasses.data() + i), _mm256_loadu_ps(storage.AwakeScales.data() + i)), deltaTime8);
+			const auto forceX = _mm256_add_ps(_mm256_loadu_ps(storage.ForcesX.data() + i), _mm256_mul_ps(gravityX8, gravityScale));
+			const auto forceY = _mm256_add_ps(_mm256_loadu_ps(storage.ForcesY.data() + i), _mm256_mul_ps(gravityY8, gravityScale));
+			const auto velocityX = _mm256_add_ps(_mm256_loadu_ps(storage.VelocitiesX.data() + i), _mm256_mul_ps(forceX, acceleration));
+			const auto velocityY = _mm256_add_ps(_mm256_loadu_ps(storage.VelocitiesY.data() + i), _mm256_mul_ps(forceY, acceleration));
+
+			_mm256_storeu_ps(storage.VelocitiesX.data() + i, velocityX);
+			_mm256_storeu_ps(storage.VelocitiesY.data() + i, velocityY);
+			_mm256_storeu_ps(storage.PositionsX.data() + i, _mm256_add_ps(_mm256_loadu_ps(storage.PositionsX.data() + i), _mm256_mul_ps(velocityX, deltaTime8)));
+			_mm256_storeu_ps(storage.PositionsY.data() + i, _mm256_add_ps(_mm256_loadu_ps(storage.PositionsY.data() + i), _mm256_mul_ps(velocityY, deltaTime8)));
+			_mm256_storeu_ps(storage.ForcesX.data() + i, _mm256_setzero_ps());
+			_mm256_storeu_ps(storage.ForcesY.data() + i, _mm256_setzero_ps());
 		}
+#endif
 
-		if (_colliders.empty()) return;
+		for (; i < end; i++)
+		{
+			const auto acceleration = storage.InverseMasses[i] * storage.AwakeScales[i] * deltaTime;
+			const auto forceX = storage.ForcesX[i] + _gravity.X * storage.GravityScales[i];
+			const auto forceY = storage.ForcesY[i] + _gravity.Y * storage.GravityScales[i];
+
+			storage.VelocitiesX[i] += forceX * acceleration;
+			storage.VelocitiesY[i] += forceY * acceleration;
+			storage.PositionsX[i] += storage.VelocitiesX[i] * deltaTime;
+			storage.PositionsY[i] += storage.VelocitiesY[i] * deltaTime;
+			storage.ForcesX[i] = 0.f;
+			storage.ForcesY[i] = 0.f;
+		}
+	}
 
-		for (auto& collider : _colliders)
+	void World::syncColliders(std::size_t begin, std::size_t end) noexcept
+	{
+		for (auto i = begin; i < end; i++)
 		{
-			if (!collider.IsEnabled()) continue;
+			auto& collider = _colliders[i];
 
-			const auto& body = GetBody(collider.GetBodyRef());
+			// The colliders of the sleeping bodies keep their position and bounds
+			if (!collider.IsEnabled() || _bodyStorage->AwakeScales[collider.GetBodyRef().Index] == 0.f) continue;
+
+			const auto& body = _bodies[collider.GetBodyRef().Index];
 
 			collider.SetPosition(body.Position() + collider.GetOffset());
 		}
 	}
 
+	void World::updateSleep() noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(updateSleep, "World::updateSleep", true);
+#endif
+
+		parallelFor(_bodyStorage->PositionsX.size(), _bodiesPerTask, [this](std::size_t, std::size_t begin, std::size_t end) {
+			auto& storage = *_bodyStorage;
+			const auto squareSleepVelocity = _sleepVelocity * _sleepVelocity;
+
+			for (auto i = begin; i < end; i++)
+			{
+				if (storage.Types[i] != BodyType::Dynamic || storage.Masses[i] < 0.f || storage.AwakeScales[i] == 0.f) continue;
+
+				const auto squareVelocity = storage.VelocitiesX[i] * storage.VelocitiesX[i] + storage.VelocitiesY[i] * storage.VelocitiesY[i];
+
+				if (squareVelocity >= squareSleepVelocity)
+				{
+					storage.SleepFrames[i] = 0;
+					continue;
+				}
+
+				if (++storage.SleepFrames[i] < _sleepFrames) continue;
+
+				storage.AwakeScales[i] = 0.f;
+				storage.VelocitiesX[i] = 0.f;
+				storage.VelocitiesY[i] = 0.f;
+			}
+		});
+	}
+
+	bool World::isResting(std::size_t bodyIndex) const noexcept
+	{
+		const auto type = _bodyStorage->Types[bodyIndex];
+
+		return type == BodyType::Static || (type == BodyType::Dynamic && _bodyStorage->AwakeScales[bodyIndex] == 0.f);
+	}
+
 	void World::Update(float deltaTime) noexcept
 	{
 #ifdef TRACY_ENABLE
 		ZoneNamedN(update, "World::Update", true);
 #endif
+		_contactEvents.Clear();
+
+		step(deltaTime);
+	}
+
+	void World::step(float deltaTime) noexcept
+	{
+		auto& storage = *_bodyStorage;
+
+		// Kept for GetInterpolatedPosition, for the updates run by Update and by Advance
+		std::copy(storage.PositionsX.begin(), storage.PositionsX.end(), storage.PreviousPositionsX.begin());
+		std::copy(storage.PositionsY.begin(), storage.PositionsY.end(), storage.PreviousPositionsY.begin());
+
+		_deltaTime = deltaTime;
+
 		updateBodies(deltaTime);
         updateColliders();
+		updateSleep();
+
+		std::fill(storage.Changed.begin(), storage.Changed.end(), 0);
 	}
 
-	BodyRef World::CreateBody() noexcept
+	void World::Clear() noexcept
+	{
+		for (std::size_t i = 0; i < _bodies.size(); i++)
+		{
+			if (!_bodies[i].IsEnabled()) continue;
+
+			DestroyBody({ i, _bodyGenerations[i] });
+		}
+
+		// Pushed from the end to use the lowest index first, like a new world
+		_freeBodies.clear();
+		_freeColliders.clear();
+
+		for (auto i = _bodies.size(); i > 0; i--)
+		{
+			_freeBodies.push_back(i - 1);
+		}
+
+		for (auto i = _colliders.size(); i > 0; i--)
+		{
+			_freeColliders.push_back(i - 1);
+		}
+
+		_broadPhaseColliders.clear();
+		_broadPhase->Update(_broadPhaseColliders);
+		_colliderPairs.clear();
+		_lastColliderPairs.clear();
+		_contactPairs.clear();
+		_persistentContacts.clear();
+		_timeOfImpacts.clear();
+		_contactEvents.Clear();
+		_accumulatedTime = 0.f;
+	}
+
+	std::size_t World::Advance(float deltaTime) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(advance, "World::Advance", true);
+#endif
+
+		std::size_t steps = 0;
+
+		_accumulatedTime += deltaTime;
+		// The events of all the fixed updates of this call are kept together
+		_contactEvents.Clear();
+
+		while (_accumulatedTime >= _fixedTimeStep && steps < _maxFixedSteps)
+		{
+			step(_fixedTimeStep);
+
+			_accumulatedTime -= _fixedTimeStep;
+			steps++;
+		}
+
+		if (_accumulatedTime >= _fixedTimeStep)
+		{
+			_accumulatedTime = std::fmod(_accumulatedTime, _fixedTimeStep);
+		}
+
+		return steps;
+	}
+
+	float World::GetInterpolationAlpha() const noexcept
+	{
+		return _accumulatedTime / _fixedTimeStep;
+	}
+
+	Math::Vec2F World::GetInterpolatedPosition(BodyRef bodyRef) const
 	{
-		for (size_t i = 0; i < _bodies.size(); i++)
+		if (_bodyGenerations[bodyRef.Index] != bodyRef.Generation)
 		{
-			if (_bodies[i].IsEnabled()) continue;
+			throw InvalidBodyRefException();
+		}
 
-			_bodies[i].Enable();
+		const auto& storage = *_bodyStorage;
+		const auto alpha = GetInterpolationAlpha();
+		const auto previous = Math::Vec2F(storage.PreviousPositionsX[bodyRef.Index], storage.PreviousPositionsY[bodyRef.Index]);
+		const auto current = Math::Vec2F(storage.PositionsX[bodyRef.Index], storage.PositionsY[bodyRef.Index]);
 
-			return {i, _bodyGenerations[i] };
+		return previous + (current - previous) * alpha;
+	}
+
+	BodyRef World::CreateBody() noexcept
+	{
+		if (_freeBodies.empty())
+		{
+			resizeBodies(_bodies.size() * 2);
 		}
 
-		// No free bodies found, create a new one, and increase the size of the vector
-        const std::size_t oldSize = _bodies.size();
-		_bodies.resize(_bodies.size() * 2);
-        _bodyGenerations.resize(_bodyGenerations.size() * 2);
+		const auto index = _freeBodies.back();
 
-		_bodies[oldSize].Enable();
+		_freeBodies.pop_back();
+		_bodies[index].Enable();
 
-		return {oldSize, _bodyGenerations[oldSize] };
+		return {index, _bodyGenerations[index] };
 	}
 
 	void World::DestroyBody(BodyRef bodyRef)
@@ -397,20 +1254,17 @@ namespace Physics
             throw InvalidBodyRefException();
         }
 
-		for (std::size_t i = 0; i < _colliders.size(); i++)
+		// Destroying a collider unlinks it, the first collider of the body changes each time
+		while (_bodyColliders[bodyRef.Index] != _noCollider)
 		{
-            auto& collider = _colliders[i];
-
-			if (collider.IsFree()) continue;
+			const auto colliderIndex = _bodyColliders[bodyRef.Index];
 
-			if (collider.GetBodyRef() == bodyRef)
-			{
-				DestroyCollider({ i, _colliderGenerations[i] });
-            }
+			DestroyCollider({ colliderIndex, _colliderGenerations[colliderIndex] });
 		}
 
 		_bodies[bodyRef.Index].Disable();
 		_bodyGenerations[bodyRef.Index]++;
+		_freeBodies.push_back(bodyRef.Index);
 	}
 
 	Body& World::GetBody(BodyRef bodyRef)
@@ -425,38 +1279,62 @@ namespace Physics
 
 	ColliderRef World::CreateCollider(BodyRef bodyRef) noexcept
 	{
-		for (size_t i = 0; i < _colliders.size(); i++)
+		if (_freeColliders.empty())
 		{
-			if (!_colliders[i].IsFree()) continue;
-
-			const ColliderRef colliderRef = { i, _colliderGenerations[i] };
+			resizeColliders(_colliders.size() * 2);
+		}
 
-			_colliders[i].SetBodyRef(bodyRef);
-			_colliders[i].Enable();
-			_colliders[i].SetColliderRef(colliderRef);
+		const auto index = _freeColliders.back();
+		const ColliderRef colliderRef = { index, _colliderGenerations[index] };
+		auto& firstCollider = _bodyColliders[bodyRef.Index];
 
-			return colliderRef;
-		}
+		_freeColliders.pop_back();
 
-		// No free colliders found, create a new one, and increase the size of the vector
-		const std::size_t oldSize = _colliders.size();
+		// Add the collider at the start of the colliders of the body
+		_colliderLinks[index] = ColliderLink{_noCollider, firstCollider};
 
-		_colliders.resize(_colliders.size() * 2);
-		_colliderGenerations.resize(_colliderGenerations.size() * 2);
+		if (firstCollider != _noCollider)
+		{
+			_colliderLinks[firstCollider].Previous = index;
+		}
 
-		const ColliderRef colliderRef = { oldSize, _colliderGenerations[oldSize] };
+		firstCollider = index;
 
-		_colliders[oldSize].SetBodyRef(bodyRef);
-		_colliders[oldSize].Enable();
-		_colliders[oldSize].SetColliderRef(colliderRef);
+		_colliders[index].SetBodyRef(bodyRef);
+		_colliders[index].Enable();
+		_colliders[index].SetColliderRef(colliderRef);
+		_bodyStorage->Changed[bodyRef.Index] = 1;
 
 		return colliderRef;
 	}
 
 	void World::DestroyCollider(ColliderRef colliderRef)
 	{
+		if (_colliderGenerations[colliderRef.Index] != colliderRef.Generation)
+		{
+			throw InvalidColliderRefException();
+		}
+
+		const auto& link = _colliderLinks[colliderRef.Index];
+
+		if (link.Previous != _noCollider)
+		{
+			_colliderLinks[link.Previous].Next = link.Next;
+		}
+		else
+		{
+			_bodyColliders[_colliders[colliderRef.Index].GetBodyRef().Index] = link.Next;
+		}
+
+		if (link.Next != _noCollider)
+		{
+			_colliderLinks[link.Next].Previous = link.Previous;
+		}
+
+		_colliderLinks[colliderRef.Index] = ColliderLink{_noCollider, _noCollider};
 		_colliders[colliderRef.Index].Free();
 		_colliderGenerations[colliderRef.Index]++;
+		_freeColliders.push_back(colliderRef.Index);
 	}
 
 	Collider& World::GetCollider(ColliderRef colliderRef)
@@ -474,13 +1352,247 @@ namespace Physics
         _contactListener = contactListener;
     }
 
+	void World::SetContactEventTypes(ContactEventTypes contactEventTypes) noexcept
+	{
+		_contactEventTypes = contactEventTypes;
+	}
+
+	const ContactEvents& World::GetContactEvents() const noexcept
+	{
+		return _contactEvents;
+	}
+
+	bool World::overlap(const Collider& collider, const Math::RectangleF& rectangle) noexcept
+	{
+		switch (collider.GetShapeType())
+		{
+			case Math::ShapeType::Circle:
+			{
+				return Math::Intersect(rectangle, collider.GetWorldCircle());
+			}
+			case Math::ShapeType::Rectangle:
+			{
+				return Math::Intersect(rectangle, collider.GetWorldRectangle());
+			}
+			case Math::ShapeType::Polygon:
+			{
+				return Math::Intersect(collider.GetWorldPolygon(), rectangle);
+			}
+			case Math::ShapeType::None: break;
+		}
+
+		return false;
+	}
+
+	bool World::overlap(const Collider& collider, const Math::CircleF& circle) noexcept
+	{
+		switch (collider.GetShapeType())
+		{
+			case Math::ShapeType::Circle:
+			{
+				return Math::Intersect(circle, collider.GetWorldCircle());
+			}
+			case Math::ShapeType::Rectangle:
+			{
+				return Math::Intersect(collider.GetWorldRectangle(), circle);
+			}
+			case Math::ShapeType::Polygon:
+			{
+				const auto& poly = collider.GetWorldPolygon();
+
+				// The circle can be inside the polygon without touching its edges
+				return Math::Intersect(poly, circle) || poly.Contains(circle.Center());
+			}
+			case Math::ShapeType::None: break;
+		}
+
+		return false;
+	}
+
+	template<typename Shape>
+	std::size_t World::query(const Math::RectangleF& bounds, const Shape& shape, std::span<ColliderRef> results, bool exact) noexcept
+	{
+		_queryCandidates.clear();
+		_broadPhase->Query(bounds, _queryCandidates);
+
+		std::size_t count = 0;
+
+		for (const auto& colliderRef : _queryCandidates)
+		{
+			if (count == results.size()) break;
+
+			// The broad phase has the colliders of the last update, they may have been destroyed or disabled since
+			if (_colliderGenerations[colliderRef.Index] != colliderRef.Generation) continue;
+
+			const auto& collider = _colliders[colliderRef.Index];
+
+			if (!collider.IsEnabled() || collider.IsFree()) continue;
+
+			if (exact && !overlap(collider, shape)) continue;
+
+			results[count++] = colliderRef;
+		}
+
+		return count;
+	}
+
+	std::size_t World::QueryAABB(const Math::RectangleF& rectangle, std::span<ColliderRef> results, bool exact) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(queryAABB, "World::QueryAABB", true);
+#endif
+
+		return query(rectangle, rectangle, results, exact);
+	}
+
+	std::size_t World::QueryPoint(Math::Vec2F point, std::span<ColliderRef> results, bool exact) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(queryPoint, "World::QueryPoint", true);
+#endif
+
+		return query(Math::RectangleF(point, point), Math::CircleF(point, 0.f), results, exact);
+	}
+
+	std::size_t World::QueryCircle(const Math::CircleF& circle, std::span<ColliderRef> results, bool exact) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(queryCircle, "World::QueryCircle", true);
+#endif
+
+		const auto radius = Math::Vec2F(circle.Radius(), circle.Radius());
+
+		return query(Math::RectangleF(circle.Center() - radius, circle.Center() + radius), circle, results, exact);
+	}
+
+	std::size_t World::RayCastBatch(std::span<const Ray> rays, std::span<RayCastHit> hits) noexcept
+	{
+#ifdef TRACY_ENABLE
+		ZoneNamedN(rayCastBatch, "World::RayCastBatch", true);
+#endif
+
+		const auto rayCount = std::min(rays.size(), hits.size());
+		std::size_t hitCount = 0;
+
+		for (std::size_t begin = 0; begin < rayCount; begin += RayPacket::Size)
+		{
+			const auto packetSize = std::min(RayPacket::Size, rayCount - begin);
+			RayPacket packet(rays.subspan(begin, packetSize));
+
+			_queryCandidates.clear();
+			_broadPhase->Query(packet.GetBounds(), _queryCandidates);
+
+			for (const auto& colliderRef : _queryCandidates)
+			{
+				if (_colliderGenerations[colliderRef.Index] != colliderRef.Generation) continue;
+
+				const auto& collider = _colliders[colliderRef.Index];
+
+				if (!collider.IsEnabled() || collider.IsFree()) continue;
+
+				// Skip the shape when no ray reaches its bounds before its closest hit
+				const auto mask = packet.IntersectBounds(collider.GetBounds());
+
+				if (mask == 0) continue;
+
+				switch (collider.GetShapeType())
+				{
+					case Math::ShapeType::Circle:
+					{
+						packet.CastCircle(collider.GetWorldCircle(), colliderRef);
+						break;
+					}
+					case Math::ShapeType::Rectangle:
+					{
+						packet.CastRectangle(collider.GetWorldRectangle(), colliderRef);
+						break;
+					}
+					case Math::ShapeType::Polygon:
+					{
+						packet.CastPolygon(collider.GetWorldPolygon(), colliderRef, mask);
+						break;
+					}
+					case Math::ShapeType::None: break;
+				}
+			}
+
+			const auto& packetHits = packet.GetHits();
+
+			for (std::size_t i = 0; i < packetSize; i++)
+			{
+				hits[begin + i] = packetHits[i];
+
+				if (packetHits[i].Hit) hitCount++;
+			}
+		}
+
+		return hitCount;
+	}
+
 	std::vector<Math::RectangleF> World::GetQuadTreeBoundaries() const noexcept
 	{
-		return _quadTree.GetBoundaries();
+		return _broadPhase->GetBoundaries();
+	}
+
+	void World::SetBroadPhase(BroadPhaseType broadPhaseType, float cellSize, float looseness) noexcept
+	{
+		_broadPhaseType = broadPhaseType;
+
+		const auto boundary = Math::RectangleF(Math::Vec2F::Zero(), Math::Vec2F::One());
+
+		switch (broadPhaseType)
+		{
+			case BroadPhaseType::QuadTree: _broadPhase = UniquePtr<BroadPhase>(new QuadTree(boundary)); break;
+			case BroadPhaseType::IncrementalQuadTree: _broadPhase = UniquePtr<BroadPhase>(new QuadTree(boundary, true)); break;
+			case BroadPhaseType::LooseQuadTree: _broadPhase = UniquePtr<BroadPhase>(new QuadTree(boundary, false, looseness)); break;
+			case BroadPhaseType::LinearQuadTree: _broadPhase = MakeUnique<BroadPhase, LinearQuadTree>(); break;
+			case BroadPhaseType::SweepAndPrune: _broadPhase = MakeUnique<BroadPhase, SweepAndPrune>(); break;
+			case BroadPhaseType::DynamicTree: _broadPhase = MakeUnique<BroadPhase, DynamicTree>(); break;
+			case BroadPhaseType::SpatialHash: _broadPhase = UniquePtr<BroadPhase>(new SpatialHash(cellSize)); break;
+		}
+
+		_broadPhase->SetThreadPool(_threadPool.Get());
+	}
+
+	BroadPhaseType World::GetBroadPhaseType() const noexcept
+	{
+		return _broadPhaseType;
+	}
+
+	void World::SetThreadCount(std::size_t threadCount) noexcept
+	{
+		_threadCount = std::max<std::size_t>(threadCount, 1);
+		_threadPool = _threadCount > 1 ? UniquePtr<ThreadPool>(new ThreadPool(_threadCount)) : UniquePtr<ThreadPool>();
+		_broadPhase->SetThreadPool(_threadPool.Get());
+	}
+
+	std::size_t World::GetThreadCount() const noexcept
+	{
+		return _threadCount;
 	}
 
     void World::SetGravity(Math::Vec2F gravity) noexcept
     {
         _gravity = gravity;
     }
+
+	void World::SetSleepThreshold(float velocity, std::size_t frames) noexcept
+	{
+		_sleepVelocity = velocity;
+		_sleepFrames = frames;
+	}
+
+	void World::SetVelocityIterations(std::size_t iterations) noexcept
+	{
+		_velocityIterations = std::max<std::size_t>(iterations, 1);
+	}
+
+	void World::SetFixedTimeStep(float timeStep, std::size_t maxSteps) noexcept
+	{
+		if (timeStep <= 0.f) return;
+
+		_fixedTimeStep = timeStep;
+		_maxFixedSteps = std::max<std::size_t>(maxSteps, 1);
+		_accumulatedTime = std::min(_accumulatedTime, timeStep);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "BroadPhase.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A pair of collider indices, the lowest index first
+ */
+using IndexPair = std::pair<std::size_t, std::size_t>;
+
+/**
+ * @brief Get the pairs of colliders whose bounds overlap by testing all of them
+ * @return The pairs with the lowest index first, sorted
+ */
+inline std::vector<IndexPair> getOverlappingPairs(const std::vector<Physics::SimplifiedCollider>& colliders)
+{
+	std::vector<IndexPair> pairs;
+
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		for (std::size_t j = i + 1; j < colliders.size(); j++)
+		{
+			if (!Math::Intersect(colliders[i].Bounds, colliders[j].Bounds)) continue;
+
+			pairs.emplace_back(std::min(colliders[i].Ref.Index, colliders[j].Ref.Index), std::max(colliders[i].Ref.Index, colliders[j].Ref.Index));
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+
+	return pairs;
+}
+
+/**
+ * @brief Get the pairs of a broad phase to compare them with getOverlappingPairs, a pair given twice is kept twice
+ * @return The pairs with the lowest index first, sorted
+ */
+inline std::vector<IndexPair> getSortedPairs(const MyVector<Physics::ColliderPair>& colliderPairs)
+{
+	std::vector<IndexPair> pairs;
+
+	pairs.reserve(colliderPairs.size());
+
+	for (const auto& colliderPair : colliderPairs)
+	{
+		pairs.emplace_back(std::min(colliderPair.A.Index, colliderPair.B.Index), std::max(colliderPair.A.Index, colliderPair.B.Index));
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+
+	return pairs;
+}
+
+/**
+ * @brief Create a grid of colliders, each one overlaps its neighbours
+ */
+inline std::vector<Physics::SimplifiedCollider> createColliders(std::size_t width, std::size_t height)
+{
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	for (std::size_t i = 0; i < width * height; i++)
+	{
+		const auto position = Math::Vec2F(static_cast<float>(i % width), static_cast<float>(i / width)) * 10.f;
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position, position + Math::Vec2F(12.f, 12.f))});
+	}
+
+	return colliders;
+}
\ No newline at end of file
@@ -3,7 +3,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <vector>
 
 using namespace Physics;
 using namespace Math;
@@ -75,7 +78,9 @@ TEST(Collider, SetIsTrigger)
 
 TEST(Collider, SetIsEnabled)
 {
-	Collider collider;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
 
 	collider.Enable();
 	collider.SetCircle(CircleF({ 1.f, 2.f }, 3.f));
@@ -89,7 +94,9 @@ TEST(Collider, SetIsEnabled)
 
 TEST(Collider, SetCircle)
 {
-	Collider collider;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
 	CircleF circle({ 1.f, 2.f }, 3.f);
 
 	collider.SetCircle(circle);
@@ -101,7 +108,9 @@ TEST(Collider, SetCircle)
 
 TEST(Collider, SetRectangle)
 {
-	Collider collider;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
 	RectangleF rectangle({ 1.f, 2.f }, { 3.f, 4.f });
 
 	collider.SetRectangle(rectangle);
@@ -113,13 +122,109 @@ TEST(Collider, SetRectangle)
 
 TEST(Collider, SetPolygon)
 {
-	Collider collider;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
 	PolygonF polygon({ { 1.f, 2.f }, { 3.f, 4.f }, { 5.f, 6.f } });
 
 	collider.SetPolygon(polygon);
 
 	EXPECT_EQ(collider.GetShapeType(), ShapeType::Polygon);
-	EXPECT_EQ(collider.GetPolygon().Vertices(), polygon.Vertices());
+	EXPECT_TRUE(std::ranges::equal(collider.GetPolygon().Vertices(), polygon.Vertices()));
+}
+
+TEST(Collider, SetLargePolygon)
+{
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
+	std::vector<Vec2F> vertices;
+
+	// More vertices than the polygon stores inline
+	for (std::size_t i = 0; i < PolygonF::InlineCapacity * 2; i++)
+	{
+		const auto angle = static_cast<float>(i) / static_cast<float>(PolygonF::InlineCapacity * 2) * 6.2831853f;
+
+		vertices.emplace_back(std::cos(angle), std::sin(angle));
+	}
+
+	collider.SetPolygon(PolygonF(vertices) + Vec2F(2.f, 0.f));
+
+	const auto& polygon = collider.GetPolygon();
+
+	ASSERT_EQ(polygon.Vertices().size(), vertices.size());
+	EXPECT_EQ(polygon.Vertices()[0], Vec2F(3.f, 0.f));
+
+	// The normals of the edges are normalized and kept when the polygon is moved
+	for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+	{
+		const auto& normal = polygon.Normals()[i];
+
+		EXPECT_NEAR(normal.Length(), 1.f, 1e-5f);
+		EXPECT_NEAR(normal.Dot(polygon.Vertices()[i] - polygon.Vertices()[j]), 0.f, 1e-5f);
+	}
+
+	EXPECT_TRUE(Intersect(polygon, PolygonF({ {0.5f, -0.5f}, {1.5f, -0.5f}, {1.5f, 0.5f} })));
+	EXPECT_FALSE(Intersect(polygon, PolygonF({ {-1.f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f} })));
+}
+
+TEST(Collider, WorldShape)
+{
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider collider(&shapeStorage);
+	const auto polygon = PolygonF({ {-1.f, -1.f}, {1.f, -1.f}, {0.f, 1.f} });
+
+	collider.SetCircle(CircleF(Vec2F(1.f, 0.f), 2.f));
+	collider.SetPosition(Vec2F(3.f, 4.f));
+
+	EXPECT_EQ(collider.GetWorldCircle().Center(), Vec2F(4.f, 4.f));
+	EXPECT_EQ(collider.GetWorldCircle().Radius(), 2.f);
+
+	// The world shape follows the shape set after the position
+	collider.SetRectangle(RectangleF(Vec2F(0.f, 0.f), Vec2F(1.f, 1.f)));
+
+	EXPECT_EQ(collider.GetWorldRectangle().MinBound(), Vec2F(3.f, 4.f));
+	EXPECT_EQ(collider.GetWorldRectangle().MaxBound(), Vec2F(4.f, 5.f));
+
+	collider.SetPolygon(polygon);
+	collider.SetPosition(Vec2F(-1.f, 2.f));
+
+	const auto& worldPolygon = collider.GetWorldPolygon();
+
+	for (std::size_t i = 0; i < polygon.Vertices().size(); i++)
+	{
+		EXPECT_EQ(worldPolygon.Vertices()[i], polygon.Vertices()[i] + Vec2F(-1.f, 2.f));
+		EXPECT_EQ(worldPolygon.Normals()[i], polygon.Normals()[i]);
+	}
+}
+
+TEST(Collider, ShapePools)
+{
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider circleCollider(&shapeStorage);
+	Collider collider(&shapeStorage);
+
+	circleCollider.SetCircle(CircleF(Vec2F::Zero(), 1.f));
+	collider.SetCircle(CircleF(Vec2F::Zero(), 2.f));
+
+	// The circles are packed together, a shape of another type goes to its own pool
+	EXPECT_EQ(shapeStorage.Circles.size(), 2);
+
+	collider.SetRectangle(RectangleF(Vec2F::Zero(), Vec2F::One()));
+
+	EXPECT_EQ(shapeStorage.Rectangles.size(), 1);
+	EXPECT_EQ(shapeStorage.FreeCircles.size(), 1);
+	EXPECT_EQ(circleCollider.GetCircle().Radius(), 1.f);
+
+	// A freed shape is reused by the next shape of its type
+	collider.Free();
+	collider.SetCircle(CircleF(Vec2F::Zero(), 3.f));
+
+	EXPECT_EQ(shapeStorage.Circles.size(), 2);
+	EXPECT_EQ(shapeStorage.FreeRectangles.size(), 1);
+	EXPECT_EQ(collider.GetCircle().Radius(), 3.f);
 }
 
 TEST(ColliderPair, DefaultConstructor)
@@ -0,0 +1,193 @@
+#include "ContactResolver.h"
+
+#include <gtest/gtest.h>
+
+using namespace Physics;
+using namespace Math;
+
+namespace
+{
+	/**
+	 * @brief Two circles that overlap, the first one falls on the second one. The colliders are placed at their body like the world does
+	 */
+	void setupFallingCircles(Body& bodyA, Body& bodyB, Collider& colliderA, Collider& colliderB) noexcept
+	{
+		bodyA.Enable();
+		bodyB.Enable();
+		bodyA.SetPosition(Vec2F(0.f, 1.9f));
+		bodyA.SetVelocity(Vec2F(0.f, -2.f));
+		colliderA.SetCircle(CircleF(Vec2F::Zero(), 1.f));
+		colliderB.SetCircle(CircleF(Vec2F::Zero(), 1.f));
+		colliderA.SetPosition(bodyA.Position());
+	}
+}
+
+TEST(ContactResolver, SolveVelocity)
+{
+	Body bodyA;
+	Body bodyB;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider colliderA(&shapeStorage);
+	Collider colliderB(&shapeStorage);
+
+	setupFallingCircles(bodyA, bodyB, colliderA, colliderB);
+
+	ContactResolver resolver(&bodyA, &bodyB, &colliderA, &colliderB);
+
+	resolver.PrepareContact(0.f);
+	resolver.SolveVelocity();
+
+	// Without bounciness the bodies stop approaching, the impulse is shared by their masses
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, -1.f);
+	EXPECT_FLOAT_EQ(bodyB.Velocity().Y, -1.f);
+	EXPECT_FLOAT_EQ(resolver.GetNormalImpulse(), 1.f);
+
+	// More iterations do not change a solved contact
+	resolver.SolveVelocity();
+
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, -1.f);
+	EXPECT_FLOAT_EQ(resolver.GetNormalImpulse(), 1.f);
+
+	resolver.SolvePosition();
+
+	EXPECT_NEAR((bodyA.Position() - bodyB.Position()).Length(), 2.f, 1e-5f);
+}
+
+TEST(ContactResolver, WarmStart)
+{
+	Body bodyA;
+	Body bodyB;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider colliderA(&shapeStorage);
+	Collider colliderB(&shapeStorage);
+
+	setupFallingCircles(bodyA, bodyB, colliderA, colliderB);
+
+	ContactResolver resolver(&bodyA, &bodyB, &colliderA, &colliderB);
+
+	// The impulse of the last update solves the contact before the first iteration
+	resolver.PrepareContact(1.f);
+
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, -1.f);
+
+	resolver.SolveVelocity();
+
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, -1.f);
+	EXPECT_FLOAT_EQ(resolver.GetNormalImpulse(), 1.f);
+}
+
+TEST(ContactResolver, NeverPull)
+{
+	Body bodyA;
+	Body bodyB;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider colliderA(&shapeStorage);
+	Collider colliderB(&shapeStorage);
+
+	setupFallingCircles(bodyA, bodyB, colliderA, colliderB);
+	bodyA.SetVelocity(Vec2F(0.f, 1.f));
+
+	ContactResolver resolver(&bodyA, &bodyB, &colliderA, &colliderB);
+
+	// A too big impulse from the last update is taken back, but not more
+	resolver.PrepareContact(3.f);
+	resolver.SolveVelocity();
+
+	EXPECT_FLOAT_EQ(resolver.GetNormalImpulse(), 0.f);
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, 1.f);
+	EXPECT_FLOAT_EQ(bodyB.Velocity().Y, 0.f);
+}
+
+TEST(ContactResolver, PolygonManifold)
+{
+	const auto square = PolygonF({ {-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f} });
+	ContactManifold<float> manifold;
+
+	// The first square lies on the second one, moved to the side
+	ASSERT_TRUE(FindContact(square + Vec2F(0.5f, 1.9f), square, manifold));
+
+	EXPECT_NEAR(manifold.Normal.X, 0.f, 1e-5f);
+	EXPECT_NEAR(manifold.Normal.Y, 1.f, 1e-5f);
+	EXPECT_NEAR(manifold.Penetration, 0.1f, 1e-5f);
+	ASSERT_EQ(manifold.PointCount, 2);
+
+	// The contact points are the corners of the overlapping part of the faces, on the face of one of the squares
+	for (int i = 0; i < manifold.PointCount; i++)
+	{
+		EXPECT_GE(manifold.Points[i].X, -0.5f - 1e-5f);
+		EXPECT_LE(manifold.Points[i].X, 1.f + 1e-5f);
+		EXPECT_GE(manifold.Points[i].Y, 0.9f - 1e-5f);
+		EXPECT_LE(manifold.Points[i].Y, 1.f + 1e-5f);
+	}
+
+	EXPECT_NEAR(std::abs(manifold.Points[0].X - manifold.Points[1].X), 1.5f, 1e-5f);
+
+	// The reference face is the one facing the other polygon, whatever the order of the polygons and their winding
+	ASSERT_TRUE(FindContact(square, square + Vec2F(0.5f, 1.9f), manifold));
+
+	EXPECT_NEAR(manifold.Normal.Y, -1.f, 1e-5f);
+	EXPECT_NEAR(manifold.Penetration, 0.1f, 1e-5f);
+	EXPECT_EQ(manifold.PointCount, 2);
+
+	const auto rectangle = ToPolygon(RectangleF(Vec2F(0.f, 0.f), Vec2F(2.f, 2.f)));
+	const auto smallRectangle = ToPolygon(RectangleF(Vec2F(0.5f, 1.9f), Vec2F(1.5f, 3.f)));
+
+	ASSERT_TRUE(FindContact(rectangle, smallRectangle, manifold));
+
+	EXPECT_NEAR(manifold.Normal.Y, -1.f, 1e-5f);
+	EXPECT_NEAR(manifold.Penetration, 0.1f, 1e-5f);
+	EXPECT_EQ(manifold.PointCount, 2);
+
+	ASSERT_TRUE(FindContact(smallRectangle, rectangle, manifold));
+
+	EXPECT_NEAR(manifold.Normal.Y, 1.f, 1e-5f);
+	EXPECT_EQ(manifold.PointCount, 2);
+
+	const auto counterClockwise = PolygonF({ {0.f, 0.f}, {2.f, 0.f}, {2.f, 2.f}, {0.f, 2.f} });
+	const auto smallCounterClockwise = PolygonF({ {0.5f, 1.9f}, {1.5f, 1.9f}, {1.5f, 3.f}, {0.5f, 3.f} });
+
+	ASSERT_TRUE(FindContact(counterClockwise, smallCounterClockwise, manifold));
+
+	EXPECT_NEAR(manifold.Normal.Y, -1.f, 1e-5f);
+	EXPECT_EQ(manifold.PointCount, 2);
+
+	for (int i = 0; i < manifold.PointCount; i++)
+	{
+		EXPECT_GE(manifold.Points[i].X, 0.5f - 1e-5f);
+		EXPECT_LE(manifold.Points[i].X, 1.5f + 1e-5f);
+	}
+
+	EXPECT_FALSE(FindContact(square + Vec2F(2.5f, 0.f), square, manifold));
+	EXPECT_TRUE(FindContact(square + Vec2F(0.f, 1.5f), RectangleF(Vec2F(-1.f, -1.f), Vec2F(1.f, 1.f)), manifold));
+	EXPECT_NEAR(manifold.Normal.Y, 1.f, 1e-5f);
+	EXPECT_NEAR(manifold.Penetration, 0.5f, 1e-5f);
+}
+
+TEST(ContactResolver, PolygonToCircle)
+{
+	Body bodyA;
+	Body bodyB;
+	HeapAllocator allocator;
+	ShapeStorage shapeStorage(allocator);
+	Collider colliderA(&shapeStorage);
+	Collider colliderB(&shapeStorage);
+
+	setupFallingCircles(bodyA, bodyB, colliderA, colliderB);
+	colliderB.SetPolygon(PolygonF({ {-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f} }));
+
+	ContactResolver resolver(&bodyA, &bodyB, &colliderA, &colliderB);
+
+	resolver.PrepareContact(0.f);
+	resolver.SolveVelocity();
+
+	// The circle rests on the top face of the polygon
+	EXPECT_FLOAT_EQ(bodyA.Velocity().Y, -1.f);
+	EXPECT_FLOAT_EQ(bodyB.Velocity().Y, -1.f);
+
+	resolver.SolvePosition();
+
+	EXPECT_NEAR(bodyA.Position().Y - bodyB.Position().Y, 2.f, 1e-5f);
+}
\ No newline at end of file
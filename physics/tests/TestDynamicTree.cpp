@@ -0,0 +1,99 @@
+#include "DynamicTree.h"
+
+#include "BroadPhaseTestUtility.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Physics;
+using namespace Math;
+
+TEST(DynamicTree, Empty)
+{
+	DynamicTree dynamicTree;
+
+	dynamicTree.Update({});
+
+	EXPECT_EQ(dynamicTree.GetCollidersCount(), 0);
+	EXPECT_EQ(dynamicTree.GetHeight(), 0);
+	EXPECT_TRUE(dynamicTree.GetAllPossiblePairs().empty());
+	EXPECT_TRUE(dynamicTree.GetBoundaries().empty());
+}
+
+TEST(DynamicTree, Pairs)
+{
+	DynamicTree dynamicTree;
+	auto colliders = createColliders(40, 5);
+
+	dynamicTree.Update(colliders);
+
+	EXPECT_EQ(dynamicTree.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(dynamicTree.GetBoundaries().size(), colliders.size() * 2 - 1);
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move the colliders a little, they stay in their enlarged bounds
+	for (auto& collider : colliders)
+	{
+		collider.Bounds = collider.Bounds + Vec2F(0.5f, -0.5f);
+	}
+
+	dynamicTree.Update(colliders);
+
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move them further, they have to be inserted again
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		const auto offset = i % 2 == 0 ? Vec2F(15.f, -7.f) : Vec2F(-15.f, 7.f);
+
+		colliders[i].Bounds = colliders[i].Bounds + offset;
+	}
+
+	dynamicTree.Update(colliders);
+
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(DynamicTree, Balanced)
+{
+	DynamicTree dynamicTree;
+	// A line of colliders added in order is the worst case of an unbalanced tree
+	const auto colliders = createColliders(1024, 1);
+
+	dynamicTree.Update(colliders);
+
+	EXPECT_LE(dynamicTree.GetHeight(), static_cast<int>(2.f * std::log2(static_cast<float>(colliders.size()))));
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(DynamicTree, RemoveColliders)
+{
+	DynamicTree dynamicTree;
+	auto colliders = createColliders(10, 10);
+
+	dynamicTree.Update(colliders);
+
+	// Colliders that are not given anymore are removed
+	colliders.erase(colliders.begin(), colliders.begin() + 50);
+	dynamicTree.Update(colliders);
+
+	EXPECT_EQ(dynamicTree.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(dynamicTree.GetBoundaries().size(), colliders.size() * 2 - 1);
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	for (const auto& pair : dynamicTree.GetAllPossiblePairs())
+	{
+		EXPECT_GE(pair.A.Index, 50);
+		EXPECT_GE(pair.B.Index, 50);
+	}
+
+	// They can be added back, reusing the freed nodes
+	colliders = createColliders(10, 10);
+	dynamicTree.Update(colliders);
+
+	EXPECT_EQ(dynamicTree.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(dynamicTree.GetBoundaries().size(), colliders.size() * 2 - 1);
+	EXPECT_EQ(getSortedPairs(dynamicTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
\ No newline at end of file
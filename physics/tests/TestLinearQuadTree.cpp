@@ -0,0 +1,97 @@
+#include "LinearQuadTree.h"
+
+#include "BroadPhaseTestUtility.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Physics;
+using namespace Math;
+
+TEST(LinearQuadTree, Empty)
+{
+	LinearQuadTree linearQuadTree;
+
+	linearQuadTree.Update({});
+
+	EXPECT_EQ(linearQuadTree.GetCollidersCount(), 0);
+	EXPECT_EQ(linearQuadTree.GetNodesCount(), 0);
+	EXPECT_TRUE(linearQuadTree.GetAllPossiblePairs().empty());
+	EXPECT_TRUE(linearQuadTree.GetBoundaries().empty());
+}
+
+TEST(LinearQuadTree, Pairs)
+{
+	LinearQuadTree linearQuadTree;
+	auto colliders = createColliders(40, 5);
+
+	linearQuadTree.Update(colliders);
+
+	EXPECT_EQ(linearQuadTree.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(linearQuadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move the colliders, remove some of them and add a big one
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		const auto offset = i % 2 == 0 ? Vec2F(15.f, -7.f) : Vec2F(-15.f, 7.f);
+
+		colliders[i].Bounds = colliders[i].Bounds + offset;
+	}
+
+	colliders.erase(colliders.begin(), colliders.begin() + 20);
+	colliders.push_back({{200, 0}, RectangleF(Vec2F(50.f, 10.f), Vec2F(150.f, 30.f))});
+	linearQuadTree.Update(colliders);
+
+	EXPECT_EQ(linearQuadTree.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(linearQuadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(LinearQuadTree, SamePosition)
+{
+	LinearQuadTree linearQuadTree;
+	std::vector<SimplifiedCollider> colliders;
+
+	// All the colliders are in the same cell of the deepest level
+	for (std::size_t i = 0; i < 10; i++)
+	{
+		colliders.push_back({{i, 0}, RectangleF(Vec2F(1.f, 1.f), Vec2F(1.f, 1.f))});
+	}
+
+	linearQuadTree.Update(colliders);
+
+	EXPECT_EQ(linearQuadTree.GetNodesCount(), 1);
+	EXPECT_EQ(getSortedPairs(linearQuadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(LinearQuadTree, ThreadPool)
+{
+	LinearQuadTree linearQuadTree;
+	const auto colliders = createColliders(50, 40);
+
+	linearQuadTree.Update(colliders);
+
+	const auto serialPairs = linearQuadTree.GetAllPossiblePairs();
+
+	EXPECT_EQ(getSortedPairs(serialPairs), getOverlappingPairs(colliders));
+
+	// The pairs are the same and in the same order whatever the number of threads
+	for (const std::size_t threadCount : {2, 3, 8})
+	{
+		ThreadPool threadPool(threadCount);
+
+		linearQuadTree.SetThreadPool(&threadPool);
+
+		const auto& pairs = linearQuadTree.GetAllPossiblePairs();
+
+		ASSERT_EQ(pairs.size(), serialPairs.size());
+
+		for (std::size_t i = 0; i < pairs.size(); i++)
+		{
+			EXPECT_EQ(pairs[i].A, serialPairs[i].A);
+			EXPECT_EQ(pairs[i].B, serialPairs[i].B);
+		}
+	}
+
+	linearQuadTree.SetThreadPool(nullptr);
+}
\ No newline at end of file
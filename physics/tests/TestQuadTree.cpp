@@ -1,5 +1,7 @@
 #include "QuadTree.h"
 
+#include "BroadPhaseTestUtility.h"
+
 #include <gtest/gtest.h>
 
 struct TestQuadTreeFixture : public ::testing::TestWithParam<Math::RectangleF> {};
@@ -130,3 +132,258 @@ TEST_P(TestQuadTreeFixture, ClearColliders)
 	EXPECT_EQ(quadTree.GetBoundaries().size(), 0);
 	EXPECT_EQ(quadTree.GetAllCollidersCount(), 0);
 }
+
+TEST_P(TestQuadTreeFixture, UpdateCollider)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect);
+	Math::Vec2F collidersSize = rect.Size() / 20.f;
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	for (std::size_t i = 0; i < 100; i++)
+	{
+		const auto position = rect.MinBound() + rect.Size() * Math::Vec2F(static_cast<float>(i % 10) / 10.f, static_cast<float>(i / 10) / 10.f);
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position, position + collidersSize)});
+		quadTree.UpdateCollider(colliders.back());
+	}
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move all colliders a bit, some of them leave their node
+	for (auto& collider : colliders)
+	{
+		collider.Bounds = collider.Bounds + collidersSize * 0.7f;
+		quadTree.UpdateCollider(collider);
+	}
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move one collider outside the boundary, the quadtree grows to contain it
+	colliders[0].Bounds = colliders[0].Bounds + rect.Size() * 3.f;
+	quadTree.UpdateCollider(colliders[0]);
+
+	EXPECT_TRUE(quadTree.Contains(colliders[0].Ref));
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST_P(TestQuadTreeFixture, RemoveCollider)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect);
+	Math::Vec2F collidersSize = rect.Size() / 100.f;
+	auto topLeftRect = Math::RectangleF(rect.MinBound(), rect.MinBound() + collidersSize);
+	auto bottomRightRect = Math::RectangleF(rect.MaxBound() - collidersSize, rect.MaxBound());
+
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	colliders.push_back({{0, 0}, bottomRightRect});
+	quadTree.UpdateCollider(colliders.back());
+
+	for (std::size_t i = 1; i <= Physics::QuadTree::MaxCapacity() + 1; i++)
+	{
+		colliders.push_back({{i, 0}, topLeftRect});
+		quadTree.UpdateCollider(colliders.back());
+	}
+
+	// The root is divided, the bottom right collider is in its own node
+	EXPECT_GT(quadTree.GetBoundaries().size(), 1);
+
+	for (std::size_t i = 1; i < colliders.size(); i++)
+	{
+		quadTree.RemoveCollider(colliders[i].Ref);
+
+		EXPECT_FALSE(quadTree.Contains(colliders[i].Ref));
+	}
+
+	// All nodes are merged back into the root
+	EXPECT_EQ(quadTree.GetBoundaries().size(), 1);
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), 1);
+	EXPECT_TRUE(quadTree.Contains(colliders[0].Ref));
+
+	quadTree.ClearColliders();
+
+	EXPECT_FALSE(quadTree.Contains(colliders[0].Ref));
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), 0);
+}
+
+TEST_P(TestQuadTreeFixture, UpdateRemovesMissingColliders)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect, true);
+	Math::Vec2F collidersSize = rect.Size() / 20.f;
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	for (std::size_t i = 0; i < 100; i++)
+	{
+		const auto position = rect.MinBound() + rect.Size() * Math::Vec2F(static_cast<float>(i % 10) / 10.f, static_cast<float>(i / 10) / 10.f);
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position, position + collidersSize)});
+	}
+
+	quadTree.Update(colliders);
+	quadTree.Update(colliders);
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+
+	// The colliders that are not given again are removed, the others keep their place
+	std::vector<Physics::SimplifiedCollider> keptColliders;
+
+	for (std::size_t i = 0; i < colliders.size(); i += 3)
+	{
+		keptColliders.push_back(colliders[i]);
+	}
+
+	quadTree.Update(keptColliders);
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), keptColliders.size());
+
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		EXPECT_EQ(quadTree.Contains(colliders[i].Ref), i % 3 == 0);
+	}
+
+	quadTree.Update(colliders);
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+}
+
+
+TEST_P(TestQuadTreeFixture, ThreadPool)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect);
+	Math::Vec2F collidersSize = rect.Size() / 30.f;
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	// Enough colliders to fill the nodes and have more than one task per node
+	for (std::size_t i = 0; i < 2'000; i++)
+	{
+		const auto position = rect.MinBound() + rect.Size() * Math::Vec2F(static_cast<float>(i * 37 % 101) / 101.f, static_cast<float>(i * 53 % 97) / 97.f);
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position, position + collidersSize)});
+	}
+
+	quadTree.Update(colliders);
+
+	const auto serialPairs = quadTree.GetAllPossiblePairs();
+
+	EXPECT_EQ(getSortedPairs(serialPairs), getOverlappingPairs(colliders));
+
+	// The pairs are the same and in the same order whatever the number of threads
+	for (const std::size_t threadCount : {2, 3, 8})
+	{
+		ThreadPool threadPool(threadCount);
+
+		quadTree.SetThreadPool(&threadPool);
+
+		const auto& pairs = quadTree.GetAllPossiblePairs();
+
+		ASSERT_EQ(pairs.size(), serialPairs.size());
+
+		for (std::size_t i = 0; i < pairs.size(); i++)
+		{
+			EXPECT_EQ(pairs[i].A, serialPairs[i].A);
+			EXPECT_EQ(pairs[i].B, serialPairs[i].B);
+		}
+	}
+
+	quadTree.SetThreadPool(nullptr);
+}
+
+TEST_P(TestQuadTreeFixture, Loose)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect);
+	Physics::QuadTree looseQuadTree(rect, false, 2.f);
+	Math::Vec2F collidersSize = rect.Size() / 50.f;
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	// Small colliders on the lines that split the root, and two in the corners so the root boundary is the rect
+	for (std::size_t i = 0; i < 40; i++)
+	{
+		const auto offset = rect.Size() * ((static_cast<float>(i % 20) + 0.5f) / 20.f);
+		const auto center = rect.Center();
+		const auto position = i < 20 ? Math::Vec2F(center.X, rect.MinBound().Y + offset.Y) : Math::Vec2F(rect.MinBound().X + offset.X, center.Y);
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position - collidersSize / 2.f, position + collidersSize / 2.f)});
+	}
+
+	colliders.push_back({{40, 0}, Math::RectangleF(rect.MinBound(), rect.MinBound() + collidersSize)});
+	colliders.push_back({{41, 0}, Math::RectangleF(rect.MaxBound() - collidersSize, rect.MaxBound())});
+
+	quadTree.Update(colliders);
+	looseQuadTree.Update(colliders);
+
+	EXPECT_FLOAT_EQ(looseQuadTree.GetLooseness(), 2.f);
+	EXPECT_EQ(looseQuadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(looseQuadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// The quadtree keeps them in the root, the loose quadtree moves them down
+	const auto isRoot = [&rect](const Math::RectangleF& boundary) {
+		return boundary.MinBound() == rect.MinBound() && boundary.MaxBound() == rect.MaxBound();
+	};
+	const auto boundaries = quadTree.GetBoundaries();
+	const auto looseBoundaries = looseQuadTree.GetBoundaries();
+
+	EXPECT_TRUE(std::any_of(boundaries.begin(), boundaries.end(), isRoot));
+	EXPECT_TRUE(std::none_of(looseBoundaries.begin(), looseBoundaries.end(), isRoot));
+
+	// The pairs are the same with several threads
+	ThreadPool threadPool(4);
+	const auto serialPairs = looseQuadTree.GetAllPossiblePairs();
+
+	looseQuadTree.SetThreadPool(&threadPool);
+
+	const auto& pairs = looseQuadTree.GetAllPossiblePairs();
+
+	ASSERT_EQ(pairs.size(), serialPairs.size());
+
+	for (std::size_t i = 0; i < pairs.size(); i++)
+	{
+		EXPECT_EQ(pairs[i].A, serialPairs[i].A);
+		EXPECT_EQ(pairs[i].B, serialPairs[i].B);
+	}
+
+	looseQuadTree.SetThreadPool(nullptr);
+}
+
+TEST_P(TestQuadTreeFixture, LooseUpdateCollider)
+{
+	auto rect = GetParam();
+	Physics::QuadTree quadTree(rect, true, 1.5f);
+	Math::Vec2F collidersSize = rect.Size() / 20.f;
+	std::vector<Physics::SimplifiedCollider> colliders;
+
+	for (std::size_t i = 0; i < 100; i++)
+	{
+		const auto position = rect.MinBound() + rect.Size() * Math::Vec2F(static_cast<float>(i % 10) / 10.f, static_cast<float>(i / 10) / 10.f);
+
+		colliders.push_back({{i, 0}, Math::RectangleF(position, position + collidersSize)});
+	}
+
+	quadTree.Update(colliders);
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move all colliders a bit, then remove half of them
+	for (auto& collider : colliders)
+	{
+		collider.Bounds = collider.Bounds + collidersSize * 0.7f;
+	}
+
+	quadTree.Update(colliders);
+
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	colliders.erase(colliders.begin(), colliders.begin() + 50);
+	quadTree.Update(colliders);
+
+	EXPECT_EQ(quadTree.GetAllCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(quadTree.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
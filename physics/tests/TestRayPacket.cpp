@@ -0,0 +1,123 @@
+#include "RayPacket.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using namespace Physics;
+using namespace Math;
+
+TEST(RayPacket, Rectangle)
+{
+	const std::array<Ray, 2> rays {
+		Ray {Vec2F(-5.f, 0.5f), Vec2F(1.f, 0.f)},
+		Ray {Vec2F(0.5f, 5.f), Vec2F(0.f, -3.f)}
+	};
+	RayPacket packet(rays);
+
+	packet.CastRectangle(RectangleF({0.f, 0.f}, {1.f, 1.f}), {1, 0});
+
+	const auto& hits = packet.GetHits();
+
+	EXPECT_TRUE(hits[0].Hit);
+	EXPECT_EQ(hits[0].Collider.Index, 1);
+	EXPECT_FLOAT_EQ(hits[0].Distance, 5.f);
+	EXPECT_FLOAT_EQ(hits[0].Point.X, 0.f);
+	EXPECT_FLOAT_EQ(hits[0].Point.Y, 0.5f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.X, -1.f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.Y, 0.f);
+
+	EXPECT_TRUE(hits[1].Hit);
+	EXPECT_FLOAT_EQ(hits[1].Distance, 4.f);
+	EXPECT_FLOAT_EQ(hits[1].Normal.X, 0.f);
+	EXPECT_FLOAT_EQ(hits[1].Normal.Y, 1.f);
+
+	// The unused rays never hit
+	EXPECT_FALSE(hits[2].Hit);
+	EXPECT_FALSE(hits[3].Hit);
+}
+
+TEST(RayPacket, Circle)
+{
+	const std::array<Ray, 4> rays {
+		Ray {Vec2F(0.f, -5.f), Vec2F(0.f, 2.f)},
+		Ray {Vec2F(0.f, -5.f), Vec2F(0.f, -1.f)},
+		Ray {Vec2F(0.f, 0.f), Vec2F(1.f, 0.f)},
+		Ray {Vec2F(-5.f, 0.f), Vec2F(1.f, 0.f), 3.f}
+	};
+	RayPacket packet(rays);
+
+	packet.CastCircle(CircleF({0.f, 0.f}, 1.f), {0, 0});
+
+	const auto& hits = packet.GetHits();
+
+	EXPECT_TRUE(hits[0].Hit);
+	EXPECT_FLOAT_EQ(hits[0].Distance, 4.f);
+	EXPECT_FLOAT_EQ(hits[0].Point.Y, -1.f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.X, 0.f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.Y, -1.f);
+
+	// Going away, starting inside and too short
+	EXPECT_FALSE(hits[1].Hit);
+	EXPECT_FALSE(hits[2].Hit);
+	EXPECT_FALSE(hits[3].Hit);
+}
+
+TEST(RayPacket, Polygon)
+{
+	const std::array<Ray, 2> rays {
+		Ray {Vec2F(0.f, -5.f), Vec2F(0.f, 1.f)},
+		Ray {Vec2F(5.f, 5.f), Vec2F(1.f, 0.f)}
+	};
+	RayPacket packet(rays);
+	const auto polygon = PolygonF({ {-1.f, -1.f}, {1.f, -1.f}, {0.f, 1.f} });
+
+	EXPECT_EQ(packet.IntersectBounds(RectangleF({-1.f, -1.f}, {1.f, 1.f})), 1);
+
+	packet.CastPolygon(polygon, {2, 0}, packet.IntersectBounds(RectangleF({-1.f, -1.f}, {1.f, 1.f})));
+
+	const auto& hits = packet.GetHits();
+
+	EXPECT_TRUE(hits[0].Hit);
+	EXPECT_FLOAT_EQ(hits[0].Distance, 4.f);
+	EXPECT_FLOAT_EQ(hits[0].Point.Y, -1.f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.X, 0.f);
+	EXPECT_FLOAT_EQ(hits[0].Normal.Y, -1.f);
+	EXPECT_FALSE(hits[1].Hit);
+}
+
+TEST(RayPacket, Closest)
+{
+	const std::array<Ray, 1> rays {
+		Ray {Vec2F(0.f, 0.f), Vec2F(1.f, 0.f)}
+	};
+	RayPacket packet(rays);
+
+	packet.CastCircle(CircleF({10.f, 0.f}, 1.f), {0, 0});
+	packet.CastRectangle(RectangleF({4.f, -1.f}, {6.f, 1.f}), {1, 0});
+	packet.CastCircle(CircleF({20.f, 0.f}, 1.f), {2, 0});
+
+	const auto& hit = packet.GetHits()[0];
+
+	EXPECT_TRUE(hit.Hit);
+	EXPECT_EQ(hit.Collider.Index, 1);
+	EXPECT_FLOAT_EQ(hit.Distance, 4.f);
+
+	// The shapes behind the closest hit are skipped
+	EXPECT_EQ(packet.IntersectBounds(RectangleF({9.f, -1.f}, {11.f, 1.f})), 0);
+}
+
+TEST(RayPacket, Bounds)
+{
+	const std::array<Ray, 2> rays {
+		Ray {Vec2F(0.f, 0.f), Vec2F(1.f, 0.f), 10.f},
+		Ray {Vec2F(2.f, 1.f), Vec2F(0.f, -1.f), 3.f}
+	};
+	RayPacket packet(rays);
+	const auto& bounds = packet.GetBounds();
+
+	EXPECT_FLOAT_EQ(bounds.MinBound().X, 0.f);
+	EXPECT_FLOAT_EQ(bounds.MinBound().Y, -2.f);
+	EXPECT_FLOAT_EQ(bounds.MaxBound().X, 10.f);
+	EXPECT_FLOAT_EQ(bounds.MaxBound().Y, 1.f);
+}
@@ -0,0 +1,84 @@
+#include "SpatialHash.h"
+
+#include "BroadPhaseTestUtility.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Physics;
+using namespace Math;
+
+TEST(SpatialHash, Empty)
+{
+	SpatialHash spatialHash;
+
+	spatialHash.Update({});
+
+	EXPECT_EQ(spatialHash.GetCollidersCount(), 0);
+	EXPECT_TRUE(spatialHash.GetAllPossiblePairs().empty());
+	EXPECT_TRUE(spatialHash.GetBoundaries().empty());
+}
+
+TEST(SpatialHash, Pairs)
+{
+	SpatialHash spatialHash;
+	auto colliders = createColliders(40, 5);
+
+	spatialHash.Update(colliders);
+
+	EXPECT_EQ(spatialHash.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(spatialHash.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move the colliders on negative cells
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		const auto offset = i % 2 == 0 ? Vec2F(-215.f, -7.f) : Vec2F(-185.f, 7.f);
+
+		colliders[i].Bounds = colliders[i].Bounds + offset;
+	}
+
+	spatialHash.Update(colliders);
+
+	EXPECT_EQ(getSortedPairs(spatialHash.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(SpatialHash, CellSize)
+{
+	SpatialHash spatialHash(100.f);
+	auto colliders = createColliders(10, 10);
+
+	spatialHash.Update(colliders);
+
+	// All the colliders start in a 100x100 square
+	EXPECT_FLOAT_EQ(spatialHash.GetCellSize(), 100.f);
+	EXPECT_EQ(spatialHash.GetBoundaries().size(), 1);
+	EXPECT_EQ(spatialHash.GetLargeCollidersCount(), 0);
+	EXPECT_EQ(getSortedPairs(spatialHash.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// The colliders bigger than a given cell size are checked against all the others
+	spatialHash.SetCellSize(1.f);
+	spatialHash.Update(colliders);
+
+	EXPECT_FLOAT_EQ(spatialHash.GetCellSize(), 1.f);
+	EXPECT_EQ(spatialHash.GetLargeCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(spatialHash.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Without a size, a big collider does not change the cells
+	spatialHash.SetCellSize(0.f);
+	colliders.push_back({{colliders.size(), 0}, RectangleF(Vec2F(-50.f, -50.f), Vec2F(1000.f, 150.f))});
+	spatialHash.Update(colliders);
+
+	EXPECT_FLOAT_EQ(spatialHash.GetCellSize(), 24.f);
+	EXPECT_EQ(spatialHash.GetLargeCollidersCount(), 1);
+	EXPECT_EQ(spatialHash.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(spatialHash.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	HeapAllocator allocator;
+	MyVector<ColliderRef> results { StandardAllocator<ColliderRef> {allocator} };
+
+	spatialHash.Query(RectangleF(Vec2F(500.f, 0.f), Vec2F(501.f, 1.f)), results);
+
+	ASSERT_EQ(results.size(), 1);
+	EXPECT_EQ(results[0], colliders.back().Ref);
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "SweepAndPrune.h"
+
+#include "BroadPhaseTestUtility.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace Physics;
+using namespace Math;
+
+TEST(SweepAndPrune, Empty)
+{
+	SweepAndPrune sweepAndPrune;
+
+	sweepAndPrune.Update({});
+
+	EXPECT_EQ(sweepAndPrune.GetCollidersCount(), 0);
+	EXPECT_TRUE(sweepAndPrune.GetAllPossiblePairs().empty());
+	EXPECT_TRUE(sweepAndPrune.GetBoundaries().empty());
+}
+
+TEST(SweepAndPrune, Pairs)
+{
+	SweepAndPrune sweepAndPrune;
+	auto colliders = createColliders(40, 5);
+
+	sweepAndPrune.Update(colliders);
+
+	EXPECT_EQ(sweepAndPrune.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(sweepAndPrune.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	// Move the colliders, the order changes on both axes
+	for (std::size_t i = 0; i < colliders.size(); i++)
+	{
+		const auto offset = i % 2 == 0 ? Vec2F(15.f, -7.f) : Vec2F(-15.f, 7.f);
+
+		colliders[i].Bounds = colliders[i].Bounds + offset;
+	}
+
+	sweepAndPrune.Update(colliders);
+
+	EXPECT_EQ(getSortedPairs(sweepAndPrune.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(SweepAndPrune, RemoveColliders)
+{
+	SweepAndPrune sweepAndPrune;
+	auto colliders = createColliders(10, 10);
+
+	sweepAndPrune.Update(colliders);
+
+	// Colliders that are not given anymore are removed
+	colliders.erase(colliders.begin(), colliders.begin() + 50);
+	sweepAndPrune.Update(colliders);
+
+	EXPECT_EQ(sweepAndPrune.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(sweepAndPrune.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+
+	for (const auto& pair : sweepAndPrune.GetAllPossiblePairs())
+	{
+		EXPECT_GE(pair.A.Index, 50);
+		EXPECT_GE(pair.B.Index, 50);
+	}
+
+	// They can be added back
+	colliders = createColliders(10, 10);
+	sweepAndPrune.Update(colliders);
+
+	EXPECT_EQ(sweepAndPrune.GetCollidersCount(), colliders.size());
+	EXPECT_EQ(getSortedPairs(sweepAndPrune.GetAllPossiblePairs()), getOverlappingPairs(colliders));
+}
+
+TEST(SweepAndPrune, Query)
+{
+	SweepAndPrune sweepAndPrune;
+	HeapAllocator allocator;
+	MyVector<ColliderRef> results { StandardAllocator<ColliderRef> {allocator} };
+	auto colliders = createColliders(100, 1);
+
+	// A long collider starts far before the bounds and still reaches them
+	colliders.push_back({{colliders.size(), 0}, RectangleF(Vec2F(-10.f, 0.f), Vec2F(985.f, 5.f))});
+	sweepAndPrune.Update(colliders);
+	sweepAndPrune.Query(RectangleF(Vec2F(980.f, 0.f), Vec2F(1000.f, 1.f)), results);
+
+	std::vector<std::size_t> indices;
+
+	for (const auto& ref : results)
+	{
+		indices.push_back(ref.Index);
+	}
+
+	std::sort(indices.begin(), indices.end());
+
+	EXPECT_EQ(indices, (std::vector<std::size_t>{97, 98, 99, 100}));
+}
\ No newline at end of file
@@ -4,7 +4,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <vector>
 
 using namespace Physics;
 using namespace Math;
@@ -18,6 +21,18 @@ INSTANTIATE_TEST_SUITE_P(World, TestWorldFixtureTime, testing::Values(
 	std::make_pair(std::array<Vec2F, 4>{ Vec2F(0.3f, 1.3f), Vec2F(0.634f, 1.f), Vec2F(0.6f, 1.6f) }, std::make_pair(0.94f, 0.3244f))
 ));
 
+struct TestWorldFixtureBroadPhase : public ::testing::TestWithParam<BroadPhaseType> {};
+
+INSTANTIATE_TEST_SUITE_P(World, TestWorldFixtureBroadPhase, testing::Values(
+	BroadPhaseType::QuadTree,
+	BroadPhaseType::IncrementalQuadTree,
+	BroadPhaseType::LooseQuadTree,
+	BroadPhaseType::LinearQuadTree,
+	BroadPhaseType::SweepAndPrune,
+	BroadPhaseType::DynamicTree,
+	BroadPhaseType::SpatialHash
+));
+
 enum class Interaction
 {
 	None, Enter, Exit, Stay
@@ -71,6 +86,43 @@ public:
     }
 };
 
+class CountingContactListener : public ContactListener
+{
+public:
+	int EnterCount {0};
+	int StayCount {0};
+	int ExitCount {0};
+
+	void OnTriggerEnter(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { EnterCount++; }
+	void OnTriggerExit(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { ExitCount++; }
+	void OnTriggerStay(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { StayCount++; }
+	void OnCollisionEnter(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { EnterCount++; }
+	void OnCollisionExit(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { ExitCount++; }
+	void OnCollisionStay(ColliderRef colliderRef, ColliderRef otherColliderRef) noexcept override { StayCount++; }
+};
+
+/**
+ * @brief Fill and update a world on the calling thread and a world with 4 threads the same way, their bodies must end at the same place
+ * @param fillWorld Create the bodies of a world and update it, the index is 0 for the world on the calling thread and 1 for the other one
+ */
+void expectSameWorldOnThreads(const std::function<std::vector<BodyRef>(World& world, std::size_t worldIndex)>& fillWorld)
+{
+	World serialWorld;
+	World parallelWorld;
+
+	parallelWorld.SetThreadCount(4);
+
+	const auto bodyRefs = fillWorld(serialWorld, 0);
+
+	ASSERT_EQ(fillWorld(parallelWorld, 1), bodyRefs);
+
+	for (const auto& bodyRef : bodyRefs)
+	{
+		EXPECT_EQ(serialWorld.GetBody(bodyRef).Position(), parallelWorld.GetBody(bodyRef).Position());
+		EXPECT_EQ(serialWorld.GetBody(bodyRef).Velocity(), parallelWorld.GetBody(bodyRef).Velocity());
+	}
+}
+
 TEST(World, CreateBody)
 {
     HeapAllocator allocator;
@@ -140,6 +192,63 @@ TEST(World, Collider)
 	EXPECT_THROW(world.GetCollider(colliderRef), InvalidColliderRefException);
 }
 
+TEST(World, CreateAndDestroyMany)
+{
+	World world(1);
+	std::vector<BodyRef> bodyRefs;
+	std::vector<std::array<ColliderRef, 3>> colliderRefs;
+
+	for (std::size_t i = 0; i < 1000; i++)
+	{
+		bodyRefs.push_back(world.CreateBody());
+		colliderRefs.push_back({
+			world.CreateCollider(bodyRefs.back()),
+			world.CreateCollider(bodyRefs.back()),
+			world.CreateCollider(bodyRefs.back())
+		});
+
+		EXPECT_EQ(bodyRefs.back().Index, i);
+	}
+
+	// Destroy a collider in the middle of the colliders of a body, then every other body
+	world.DestroyCollider(colliderRefs[1][1]);
+
+	EXPECT_THROW(world.DestroyCollider(colliderRefs[1][1]), InvalidColliderRefException);
+
+	for (std::size_t i = 1; i < bodyRefs.size(); i += 2)
+	{
+		world.DestroyBody(bodyRefs[i]);
+	}
+
+	for (std::size_t i = 0; i < bodyRefs.size(); i++)
+	{
+		for (const auto& colliderRef : colliderRefs[i])
+		{
+			if (i % 2 == 1)
+			{
+				EXPECT_THROW(world.GetCollider(colliderRef), InvalidColliderRefException);
+			}
+			else
+			{
+				EXPECT_EQ(world.GetCollider(colliderRef).GetBodyRef(), bodyRefs[i]);
+			}
+		}
+	}
+
+	// The destroyed slots are used again before growing
+	for (std::size_t i = 0; i < 500; i++)
+	{
+		const auto bodyRef = world.CreateBody();
+		const auto colliderRef = world.CreateCollider(bodyRef);
+
+		EXPECT_EQ(bodyRef.Index % 2, 1);
+		EXPECT_EQ(bodyRef.Generation, 1);
+		EXPECT_EQ(colliderRef.Generation, 1);
+	}
+
+	EXPECT_EQ(world.CreateBody().Index, 1000);
+}
+
 TEST_P(TestWorldFixtureTime, Update)
 {
     HeapAllocator allocator;
@@ -170,6 +279,69 @@ TEST_P(TestWorldFixtureTime, Update)
 	EXPECT_FLOAT_EQ(body.Force().Y, 0.f);
 }
 
+TEST(World, UpdateBodyTypes)
+{
+	World world(4);
+	std::vector<BodyRef> bodyRefs;
+	const auto gravity = Vec2F(0.f, -10.f);
+	const auto deltaTime = 0.5f;
+
+	world.SetGravity(gravity);
+
+	// Enough bodies for the 8 wide integration and the remaining ones
+	for (std::size_t i = 0; i < 21; i++)
+	{
+		const auto bodyRef = world.CreateBody();
+		auto& body = world.GetBody(bodyRef);
+
+		body.SetBodyType(i % 4 == 2 ? BodyType::Kinematic : i % 4 == 3 ? BodyType::Static : BodyType::Dynamic);
+		body.SetPosition(Vec2F(static_cast<float>(i), 1.f));
+		body.SetVelocity(Vec2F(1.f, static_cast<float>(i)));
+		body.SetMass(2.f);
+		body.SetUseGravity(i % 4 == 0);
+		body.AddForce(Vec2F(4.f, 0.f));
+		bodyRefs.push_back(bodyRef);
+	}
+
+	world.DestroyBody(bodyRefs[5]);
+	world.Update(deltaTime);
+
+	for (std::size_t i = 0; i < bodyRefs.size(); i++)
+	{
+		if (i == 5) continue;
+
+		const auto& body = world.GetBody(bodyRefs[i]);
+		auto velocity = Vec2F(1.f, static_cast<float>(i));
+
+		if (i % 4 == 3)
+		{
+			velocity = Vec2F::Zero();
+		}
+		else if (i % 4 != 2)
+		{
+			const auto force = Vec2F(4.f, 0.f) + (i % 4 == 0 ? gravity : Vec2F::Zero());
+
+			velocity += force * 0.5f * deltaTime;
+		}
+
+		const auto position = Vec2F(static_cast<float>(i), 1.f) + velocity * deltaTime;
+
+		EXPECT_FLOAT_EQ(body.Velocity().X, velocity.X);
+		EXPECT_FLOAT_EQ(body.Velocity().Y, velocity.Y);
+		EXPECT_FLOAT_EQ(body.Position().X, position.X);
+		EXPECT_FLOAT_EQ(body.Position().Y, position.Y);
+		EXPECT_FLOAT_EQ(body.Force().X, 0.f);
+		EXPECT_FLOAT_EQ(body.Force().Y, 0.f);
+	}
+
+	// The destroyed body is disabled and does not move
+	const auto bodyRef = world.CreateBody();
+
+	EXPECT_EQ(bodyRef.Index, 5);
+	EXPECT_EQ(world.GetBody(bodyRef).Position(), Vec2F::Zero());
+	EXPECT_EQ(world.GetBody(bodyRef).Velocity(), Vec2F::Zero());
+}
+
 TEST(World, TriggerCircle)
 {
     HeapAllocator allocator;
@@ -471,4 +643,832 @@ TEST(World, CollisionCircleAndRectangle)
 
 	world.DestroyBody(bodyRef2);
 	world.DestroyBody(bodyRef3);
-}
\ No newline at end of file
+}
+
+TEST_P(TestWorldFixtureBroadPhase, Trigger)
+{
+	HeapAllocator allocator;
+	World world;
+
+	world.SetBroadPhase(GetParam());
+
+	EXPECT_EQ(world.GetBroadPhaseType(), GetParam());
+
+	auto bodyRef2 = world.CreateBody();
+	auto colliderRef2 = world.CreateCollider(bodyRef2);
+	auto& collider2 = world.GetCollider(colliderRef2);
+	auto interaction = Interaction::None;
+	auto interactionCount = 0;
+	auto* contactListener = new TestContactListener(interaction, interactionCount);
+
+	world.SetContactListener(contactListener);
+	collider2.SetCircle(CircleF({0.1f, 0.1f}, 1.f));
+	collider2.SetIsTrigger(true);
+
+	auto bodyRef3 = world.CreateBody();
+	auto colliderRef3 = world.CreateCollider(bodyRef3);
+	auto& collider3 = world.GetCollider(colliderRef3);
+
+	collider3.SetCircle(CircleF({0.f, 0.f}, 1.f));
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(interaction, Interaction::Enter);
+	EXPECT_EQ(interactionCount, 1);
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(interaction, Interaction::Stay);
+	EXPECT_EQ(interactionCount, 2);
+
+	world.GetBody(bodyRef2).SetPosition({ 10.f, 10.f });
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(interaction, Interaction::Exit);
+	EXPECT_EQ(interactionCount, 3);
+
+	// Destroyed colliders are removed from the broad phase
+	world.DestroyBody(bodyRef2);
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(interactionCount, 3);
+
+	world.DestroyBody(bodyRef3);
+}
+
+
+TEST_P(TestWorldFixtureBroadPhase, Query)
+{
+	World world;
+
+	world.SetBroadPhase(GetParam());
+	world.SetGravity(Vec2F::Zero());
+
+	auto circleBodyRef = world.CreateBody();
+	auto circleRef = world.CreateCollider(circleBodyRef);
+
+	world.GetCollider(circleRef).SetCircle(CircleF({0.f, 0.f}, 1.f));
+
+	auto rectangleBodyRef = world.CreateBody();
+	auto rectangleRef = world.CreateCollider(rectangleBodyRef);
+
+	world.GetBody(rectangleBodyRef).SetPosition({5.f, 0.f});
+	world.GetCollider(rectangleRef).SetRectangle(RectangleF({-1.f, -1.f}, {1.f, 1.f}));
+
+	auto polygonBodyRef = world.CreateBody();
+	auto polygonRef = world.CreateCollider(polygonBodyRef);
+
+	world.GetBody(polygonBodyRef).SetPosition({10.f, 0.f});
+	world.GetCollider(polygonRef).SetPolygon(PolygonF({ {-2.f, -2.f}, {2.f, -2.f}, {0.f, 2.f} }));
+
+	world.Update(1.f / 60.f);
+
+	std::array<ColliderRef, 4> results {};
+	const auto contains = [&results](std::size_t count, ColliderRef colliderRef) {
+		return std::find(results.begin(), results.begin() + static_cast<std::ptrdiff_t>(count), colliderRef) != results.begin() + static_cast<std::ptrdiff_t>(count);
+	};
+
+	// The point is in the bounds of the circle but not in the circle
+	EXPECT_EQ(world.QueryPoint({0.9f, 0.9f}, results), 1);
+	EXPECT_EQ(results[0], circleRef);
+	EXPECT_EQ(world.QueryPoint({0.9f, 0.9f}, results, true), 0);
+	EXPECT_EQ(world.QueryPoint({10.f, -1.f}, results, true), 1);
+	EXPECT_EQ(results[0], polygonRef);
+
+	auto count = world.QueryAABB(RectangleF({-2.f, -2.f}, {5.f, 0.f}), results);
+
+	EXPECT_EQ(count, 2);
+	EXPECT_TRUE(contains(count, circleRef));
+	EXPECT_TRUE(contains(count, rectangleRef));
+	EXPECT_EQ(world.QueryAABB(RectangleF({-100.f, -100.f}, {100.f, 100.f}), results, true), 3);
+	EXPECT_EQ(world.QueryAABB(RectangleF({-100.f, -100.f}, {100.f, 100.f}), std::span(results).first(2)), 2);
+	EXPECT_EQ(world.QueryAABB(RectangleF({6.5f, -1.f}, {7.5f, 1.f}), results), 0);
+
+	// The circle is inside the polygon without touching its edges
+	EXPECT_EQ(world.QueryCircle(CircleF({10.f, -1.f}, 0.5f), results, true), 1);
+	EXPECT_EQ(results[0], polygonRef);
+	EXPECT_EQ(world.QueryCircle(CircleF({1.2f, 1.2f}, 0.25f), results), 1);
+	EXPECT_EQ(world.QueryCircle(CircleF({1.2f, 1.2f}, 0.25f), results, true), 0);
+
+	// The destroyed colliders are not given even before the next update
+	world.DestroyCollider(circleRef);
+
+	EXPECT_EQ(world.QueryPoint({0.f, 0.f}, results), 0);
+}
+
+TEST_P(TestWorldFixtureBroadPhase, RayCastBatch)
+{
+	World world;
+
+	world.SetBroadPhase(GetParam());
+	world.SetGravity(Vec2F::Zero());
+
+	std::array<ColliderRef, 10> colliderRefs {};
+
+	// A row of circles, then a rectangle and a polygon further
+	for (std::size_t i = 0; i < 8; i++)
+	{
+		auto bodyRef = world.CreateBody();
+
+		colliderRefs[i] = world.CreateCollider(bodyRef);
+		world.GetBody(bodyRef).SetPosition({static_cast<float>(i) * 4.f, 10.f});
+		world.GetCollider(colliderRefs[i]).SetCircle(CircleF({0.f, 0.f}, 1.f));
+	}
+
+	auto rectangleBodyRef = world.CreateBody();
+
+	colliderRefs[8] = world.CreateCollider(rectangleBodyRef);
+	world.GetBody(rectangleBodyRef).SetPosition({40.f, 0.f});
+	world.GetCollider(colliderRefs[8]).SetRectangle(RectangleF({-1.f, -1.f}, {1.f, 1.f}));
+
+	auto polygonBodyRef = world.CreateBody();
+
+	colliderRefs[9] = world.CreateCollider(polygonBodyRef);
+	world.GetBody(polygonBodyRef).SetPosition({40.f, 20.f});
+	world.GetCollider(colliderRefs[9]).SetPolygon(PolygonF({ {-1.f, -1.f}, {1.f, -1.f}, {0.f, 1.f} }));
+
+	world.Update(1.f / 60.f);
+
+	std::array<Ray, 11> rays {};
+
+	// One ray going up to each circle, the last ones from its center, too short and missing everything
+	for (std::size_t i = 0; i < 8; i++)
+	{
+		rays[i] = Ray {Vec2F(static_cast<float>(i) * 4.f, 0.f), Vec2F(0.f, 1.f)};
+	}
+
+	rays[5] = Ray {Vec2F(20.f, 10.f), Vec2F(0.f, 1.f)};
+	rays[6] = Ray {Vec2F(24.f, 0.f), Vec2F(0.f, 1.f), 5.f};
+	rays[7] = Ray {Vec2F(28.f, 0.f), Vec2F(0.f, -1.f)};
+	rays[8] = Ray {Vec2F(30.f, 0.f), Vec2F(1.f, 0.f)};
+	rays[9] = Ray {Vec2F(40.f, 10.f), Vec2F(0.f, 1.f)};
+	rays[10] = Ray {Vec2F(-10.f, 10.f), Vec2F(1.f, 0.f)};
+
+	std::array<RayCastHit, 11> hits {};
+
+	EXPECT_EQ(world.RayCastBatch(rays, hits), 8);
+
+	for (std::size_t i = 0; i < 5; i++)
+	{
+		EXPECT_TRUE(hits[i].Hit);
+		EXPECT_EQ(hits[i].Collider, colliderRefs[i]);
+		EXPECT_FLOAT_EQ(hits[i].Distance, 9.f);
+		EXPECT_FLOAT_EQ(hits[i].Normal.Y, -1.f);
+	}
+
+	EXPECT_FALSE(hits[5].Hit);
+	EXPECT_FALSE(hits[6].Hit);
+	EXPECT_FALSE(hits[7].Hit);
+
+	EXPECT_TRUE(hits[8].Hit);
+	EXPECT_EQ(hits[8].Collider, colliderRefs[8]);
+	EXPECT_FLOAT_EQ(hits[8].Distance, 9.f);
+	EXPECT_FLOAT_EQ(hits[8].Normal.X, -1.f);
+
+	EXPECT_TRUE(hits[9].Hit);
+	EXPECT_EQ(hits[9].Collider, colliderRefs[9]);
+	EXPECT_FLOAT_EQ(hits[9].Distance, 9.f);
+	EXPECT_FLOAT_EQ(hits[9].Normal.Y, -1.f);
+
+	// The closest circle of the row
+	EXPECT_TRUE(hits[10].Hit);
+	EXPECT_EQ(hits[10].Collider, colliderRefs[0]);
+	EXPECT_FLOAT_EQ(hits[10].Distance, 9.f);
+
+	// Only the rays that have a hit are cast
+	EXPECT_EQ(world.RayCastBatch(rays, std::span(hits).first(2)), 2);
+}
+
+TEST_P(TestWorldFixtureBroadPhase, ContactEvents)
+{
+	World world;
+	CountingContactListener contactListener;
+
+	world.SetBroadPhase(GetParam());
+	world.SetGravity(Vec2F::Zero());
+	world.SetContactListener(&contactListener);
+
+	std::array<BodyRef, 10> bodyRefs {};
+	std::array<ColliderRef, 10> colliderRefs {};
+
+	// A row of triggers, each one overlaps the next one
+	for (std::size_t i = 0; i < bodyRefs.size(); i++)
+	{
+		bodyRefs[i] = world.CreateBody();
+		colliderRefs[i] = world.CreateCollider(bodyRefs[i]);
+		world.GetBody(bodyRefs[i]).SetPosition({static_cast<float>(i) * 1.5f, 0.f});
+		world.GetCollider(colliderRefs[i]).SetCircle(CircleF({0.f, 0.f}, 1.f));
+		world.GetCollider(colliderRefs[i]).SetIsTrigger(true);
+	}
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.EnterCount, 9);
+	EXPECT_EQ(contactListener.StayCount, 0);
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.EnterCount, 9);
+	EXPECT_EQ(contactListener.StayCount, 9);
+
+	world.GetBody(bodyRefs[9]).SetPosition({100.f, 0.f});
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.StayCount, 17);
+	EXPECT_EQ(contactListener.ExitCount, 1);
+
+	// The contacts of a destroyed collider end without exit event
+	world.DestroyCollider(colliderRefs[0]);
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.StayCount, 24);
+	EXPECT_EQ(contactListener.ExitCount, 1);
+
+	// A new collider at the index of the destroyed one is a new contact
+	auto colliderRef = world.CreateCollider(bodyRefs[0]);
+
+	EXPECT_EQ(colliderRef.Index, colliderRefs[0].Index);
+
+	world.GetCollider(colliderRef).SetCircle(CircleF({0.f, 0.f}, 1.f));
+	world.GetCollider(colliderRef).SetIsTrigger(true);
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.EnterCount, 10);
+	EXPECT_EQ(contactListener.StayCount, 31);
+}
+
+TEST_P(TestWorldFixtureBroadPhase, ThreadCount)
+{
+	std::array<CountingContactListener, 2> contactListeners {};
+
+	expectSameWorldOnThreads([this, &contactListeners](World& world, std::size_t worldIndex) {
+		std::vector<BodyRef> bodyRefs;
+
+		world.SetBroadPhase(GetParam());
+		world.SetGravity(Vec2F(0.f, -10.f));
+		world.SetContactListener(&contactListeners[worldIndex]);
+
+		// Enough bodies and colliders for several tasks in each stage, some of them overlap and collide
+		for (std::size_t i = 0; i < 2000; i++)
+		{
+			const auto bodyRef = world.CreateBody();
+			const auto colliderRef = world.CreateCollider(bodyRef);
+			auto& body = world.GetBody(bodyRef);
+
+			body.SetPosition(Vec2F(static_cast<float>(i % 50) * 1.8f, static_cast<float>(i / 50) * 1.8f));
+			body.SetVelocity(Vec2F(static_cast<float>(i % 7) - 3.f, static_cast<float>(i % 5) - 2.f));
+			body.SetUseGravity(i % 3 == 0);
+			body.SetBodyType(i % 10 == 0 ? BodyType::Static : BodyType::Dynamic);
+
+			if (i % 2 == 0)
+			{
+				world.GetCollider(colliderRef).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+			}
+			else
+			{
+				world.GetCollider(colliderRef).SetRectangle(RectangleF(Vec2F(-1.f, -1.f), Vec2F(1.f, 1.f)));
+			}
+
+			world.GetCollider(colliderRef).SetIsTrigger(i % 4 == 1);
+			bodyRefs.push_back(bodyRef);
+		}
+
+		for (std::size_t i = 0; i < 10; i++)
+		{
+			world.Update(1.f / 60.f);
+		}
+
+		return bodyRefs;
+	});
+
+	EXPECT_GT(contactListeners[0].StayCount, 0);
+	EXPECT_EQ(contactListeners[0].EnterCount, contactListeners[1].EnterCount);
+	EXPECT_EQ(contactListeners[0].StayCount, contactListeners[1].StayCount);
+	EXPECT_EQ(contactListeners[0].ExitCount, contactListeners[1].ExitCount);
+}
+
+TEST(World, LooseQuadTreeLooseness)
+{
+	std::array<int, 3> enterCounts {};
+	std::array<std::size_t, 3> boundaryCounts {};
+	const std::array<float, 3> loosenesses { 1.f, 1.5f, 4.f };
+
+	for (std::size_t l = 0; l < loosenesses.size(); l++)
+	{
+		World world;
+		CountingContactListener contactListener;
+
+		world.SetBroadPhase(BroadPhaseType::LooseQuadTree, 0.f, loosenesses[l]);
+		world.SetContactListener(&contactListener);
+
+		// Overlapping colliders on the borders of the nodes, a looser quadtree puts more of them in the children
+		for (std::size_t i = 0; i < 400; i++)
+		{
+			const auto bodyRef = world.CreateBody();
+			const auto colliderRef = world.CreateCollider(bodyRef);
+
+			world.GetBody(bodyRef).SetPosition(Vec2F(static_cast<float>(i % 20) * 1.5f, static_cast<float>(i / 20) * 1.5f));
+			world.GetCollider(colliderRef).SetRectangle(RectangleF(Vec2F(-1.f, -1.f), Vec2F(1.f, 1.f)));
+			world.GetCollider(colliderRef).SetIsTrigger(true);
+		}
+
+		world.Update(1.f / 60.f);
+
+		enterCounts[l] = contactListener.EnterCount;
+		boundaryCounts[l] = world.GetQuadTreeBoundaries().size();
+	}
+
+	// Each collider overlaps its 8 neighbours
+	EXPECT_EQ(enterCounts[0], 2 * 19 * 20 + 2 * 19 * 19);
+	EXPECT_EQ(enterCounts[1], enterCounts[0]);
+	EXPECT_EQ(enterCounts[2], enterCounts[0]);
+	EXPECT_LT(boundaryCounts[0], boundaryCounts[2]);
+}
+
+TEST(World, Islands)
+{
+	expectSameWorldOnThreads([](World& world, std::size_t) {
+		std::vector<BodyRef> bodyRefs;
+
+		world.SetGravity(Vec2F(0.f, -10.f));
+
+		// Separate piles of overlapping circles, each pile on its own static ground
+		for (std::size_t pile = 0; pile < 8; pile++)
+		{
+			const auto x = static_cast<float>(pile) * 20.f;
+			const auto groundRef = world.CreateBody();
+
+			world.GetBody(groundRef).SetBodyType(BodyType::Static);
+			world.GetBody(groundRef).SetPosition(Vec2F(x, 0.f));
+			world.GetCollider(world.CreateCollider(groundRef)).SetRectangle(RectangleF(Vec2F(-5.f, -1.f), Vec2F(5.f, 0.f)));
+
+			for (std::size_t i = 0; i < 10; i++)
+			{
+				const auto bodyRef = world.CreateBody();
+				auto& body = world.GetBody(bodyRef);
+
+				body.SetPosition(Vec2F(x + static_cast<float>(i % 3) * 0.5f, 0.8f + static_cast<float>(i) * 1.5f));
+				body.SetUseGravity(true);
+				world.GetCollider(world.CreateCollider(bodyRef)).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+				bodyRefs.push_back(bodyRef);
+			}
+		}
+
+		for (std::size_t i = 0; i < 30; i++)
+		{
+			world.Update(1.f / 60.f);
+		}
+
+		// The grounds hold the piles
+		for (const auto& bodyRef : bodyRefs)
+		{
+			EXPECT_GT(world.GetBody(bodyRef).Position().Y, 0.f);
+		}
+
+		return bodyRefs;
+	});
+}
+
+TEST(World, Sleep)
+{
+	World world;
+
+	world.SetGravity(Vec2F(0.f, -10.f));
+	world.SetSleepThreshold(0.01f, 10);
+
+	// A resting body and a body that moves towards it
+	const auto restingRef = world.CreateBody();
+	const auto movingRef = world.CreateBody();
+
+	world.GetBody(movingRef).SetPosition(Vec2F(-10.f, 0.f));
+	world.GetCollider(world.CreateCollider(restingRef)).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+	world.GetCollider(world.CreateCollider(movingRef)).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+
+	for (std::size_t i = 0; i < 9; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	EXPECT_TRUE(world.GetBody(restingRef).IsAwake());
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_FALSE(world.GetBody(restingRef).IsAwake());
+	EXPECT_FALSE(world.GetBody(movingRef).IsAwake());
+
+	// A sleeping body is not moved by the gravity
+	world.GetBody(restingRef).SetUseGravity(true);
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(world.GetBody(restingRef).Position(), Vec2F::Zero());
+
+	// Setting a velocity wakes up a body and a moving body wakes up the sleeping body it touches
+	world.GetBody(restingRef).SetUseGravity(false);
+	world.GetBody(movingRef).SetVelocity(Vec2F(60.f, 0.f));
+
+	EXPECT_TRUE(world.GetBody(movingRef).IsAwake());
+
+	for (std::size_t i = 0; i < 10 && !world.GetBody(restingRef).IsAwake(); i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	EXPECT_TRUE(world.GetBody(restingRef).IsAwake());
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_GT(world.GetBody(restingRef).Velocity().X, 0.f);
+}
+
+TEST(World, SleepOnGround)
+{
+	World world;
+
+	world.SetGravity(Vec2F(0.f, -10.f));
+	world.SetSleepThreshold(0.5f, 10);
+
+	const auto groundRef = world.CreateBody();
+	const auto bodyRef = world.CreateBody();
+
+	world.GetBody(groundRef).SetBodyType(BodyType::Static);
+	world.GetCollider(world.CreateCollider(groundRef)).SetRectangle(RectangleF(Vec2F(-5.f, -1.f), Vec2F(5.f, 0.f)));
+	world.GetBody(bodyRef).SetPosition(Vec2F(0.f, 0.9f));
+	world.GetBody(bodyRef).SetUseGravity(true);
+	world.GetCollider(world.CreateCollider(bodyRef)).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+
+	// The ground pushes the body at each update, it still falls asleep
+	for (std::size_t i = 0; i < 60; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	EXPECT_FALSE(world.GetBody(bodyRef).IsAwake());
+	EXPECT_GT(world.GetBody(bodyRef).Position().Y, 0.f);
+}
+
+TEST(World, SleepWithoutGround)
+{
+	World world;
+
+	world.SetGravity(Vec2F(0.f, -10.f));
+	world.SetSleepThreshold(0.5f, 10);
+
+	const auto groundRef = world.CreateBody();
+	const auto bodyRef = world.CreateBody();
+
+	world.GetBody(groundRef).SetBodyType(BodyType::Static);
+	world.GetCollider(world.CreateCollider(groundRef)).SetRectangle(RectangleF(Vec2F(-5.f, -1.f), Vec2F(5.f, 0.f)));
+	world.GetBody(bodyRef).SetPosition(Vec2F(0.f, 0.9f));
+	world.GetBody(bodyRef).SetUseGravity(true);
+	world.GetCollider(world.CreateCollider(bodyRef)).SetRectangle(RectangleF(Vec2F(-1.f, -1.f), Vec2F(1.f, 1.f)));
+
+	for (std::size_t i = 0; i < 60; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	ASSERT_FALSE(world.GetBody(bodyRef).IsAwake());
+
+	// The body falls when the ground under it is removed
+	world.DestroyBody(groundRef);
+
+	const auto sleepingY = world.GetBody(bodyRef).Position().Y;
+
+	for (std::size_t i = 0; i < 10; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	EXPECT_TRUE(world.GetBody(bodyRef).IsAwake());
+	EXPECT_LT(world.GetBody(bodyRef).Position().Y, sleepingY);
+}
+
+TEST(World, SleepOnMovedPlatform)
+{
+	World world;
+
+	world.SetGravity(Vec2F(0.f, -10.f));
+	world.SetSleepThreshold(0.5f, 10);
+
+	const auto platformRef = world.CreateBody();
+	const auto bodyRef = world.CreateBody();
+
+	world.GetBody(platformRef).SetBodyType(BodyType::Static);
+	world.GetCollider(world.CreateCollider(platformRef)).SetRectangle(RectangleF(Vec2F(-5.f, -1.f), Vec2F(5.f, 0.f)));
+	world.GetBody(bodyRef).SetPosition(Vec2F(0.f, 0.9f));
+	world.GetBody(bodyRef).SetUseGravity(true);
+	world.GetCollider(world.CreateCollider(bodyRef)).SetRectangle(RectangleF(Vec2F(-1.f, -1.f), Vec2F(1.f, 1.f)));
+
+	for (std::size_t i = 0; i < 60; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	ASSERT_FALSE(world.GetBody(bodyRef).IsAwake());
+
+	// The body falls when the platform under it is moved away
+	world.GetBody(platformRef).SetPosition(Vec2F(20.f, 0.f));
+
+	const auto sleepingY = world.GetBody(bodyRef).Position().Y;
+
+	for (std::size_t i = 0; i < 10; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	EXPECT_TRUE(world.GetBody(bodyRef).IsAwake());
+	EXPECT_LT(world.GetBody(bodyRef).Position().Y, sleepingY);
+
+	// A platform moved into the sleeping body wakes it up
+	for (std::size_t i = 0; i < 10; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	world.GetBody(bodyRef).SetVelocity(Vec2F::Zero());
+	world.SetGravity(Vec2F::Zero());
+
+	for (std::size_t i = 0; i < 60; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	ASSERT_FALSE(world.GetBody(bodyRef).IsAwake());
+
+	world.GetBody(platformRef).SetPosition(world.GetBody(bodyRef).Position() + Vec2F(0.f, -0.5f));
+	world.Update(1.f / 60.f);
+
+	EXPECT_TRUE(world.GetBody(bodyRef).IsAwake());
+}
+
+TEST(World, Stack)
+{
+	World world;
+	std::vector<BodyRef> bodyRefs;
+
+	world.SetGravity(Vec2F(0.f, -10.f));
+
+	const auto groundRef = world.CreateBody();
+
+	world.GetBody(groundRef).SetBodyType(BodyType::Static);
+	world.GetCollider(world.CreateCollider(groundRef)).SetRectangle(RectangleF(Vec2F(-5.f, -1.f), Vec2F(5.f, 0.f)));
+
+	for (std::size_t i = 0; i < 5; i++)
+	{
+		const auto bodyRef = world.CreateBody();
+
+		world.GetBody(bodyRef).SetPosition(Vec2F(0.f, 0.5f + static_cast<float>(i)));
+		world.GetBody(bodyRef).SetUseGravity(true);
+		world.GetCollider(world.CreateCollider(bodyRef)).SetRectangle(RectangleF(Vec2F(-0.5f, -0.5f), Vec2F(0.5f, 0.5f)));
+		bodyRefs.push_back(bodyRef);
+	}
+
+	for (std::size_t i = 0; i < 120; i++)
+	{
+		world.Update(1.f / 60.f);
+	}
+
+	// The boxes rest on each other without sinking
+	for (std::size_t i = 0; i < bodyRefs.size(); i++)
+	{
+		const auto& body = world.GetBody(bodyRefs[i]);
+
+		EXPECT_NEAR(body.Velocity().Y, 0.f, 0.01f);
+		EXPECT_NEAR(body.Position().Y, 0.5f + static_cast<float>(i), 0.1f);
+	}
+}
+
+TEST(World, Advance)
+{
+	World world;
+
+	world.SetFixedTimeStep(0.1f, 3);
+
+	const auto bodyRef = world.CreateBody();
+
+	world.GetBody(bodyRef).SetVelocity(Vec2F(1.f, 0.f));
+
+	// Less than a step runs nothing, the time is kept for the next call
+	EXPECT_EQ(world.Advance(0.05f), 0);
+	EXPECT_NEAR(world.GetInterpolationAlpha(), 0.5f, 1e-4f);
+	EXPECT_EQ(world.Advance(0.2f), 2);
+	EXPECT_NEAR(world.GetInterpolationAlpha(), 0.5f, 1e-4f);
+	EXPECT_NEAR(world.GetBody(bodyRef).Position().X, 0.2f, 1e-4f);
+	EXPECT_NEAR(world.GetInterpolatedPosition(bodyRef).X, 0.15f, 1e-4f);
+
+	// The steps over the max are dropped
+	EXPECT_EQ(world.Advance(1.f), 3);
+	EXPECT_LT(world.GetInterpolationAlpha(), 1.f);
+	EXPECT_NEAR(world.GetBody(bodyRef).Position().X, 0.5f, 1e-4f);
+
+	// A body set to a position is not interpolated from its last one
+	world.GetBody(bodyRef).SetPosition(Vec2F(10.f, 0.f));
+
+	EXPECT_EQ(world.GetInterpolatedPosition(bodyRef), Vec2F(10.f, 0.f));
+
+	// A plain update is interpolated from the position before it
+	world.Update(0.1f);
+	world.Update(0.1f);
+
+	EXPECT_NEAR(world.GetBody(bodyRef).Position().X, 10.2f, 1e-4f);
+	EXPECT_NEAR(world.GetInterpolatedPosition(bodyRef).X, 10.1f + 0.1f * world.GetInterpolationAlpha(), 1e-4f);
+
+	world.DestroyBody(bodyRef);
+
+	EXPECT_THROW(static_cast<void>(world.GetInterpolatedPosition(bodyRef)), InvalidBodyRefException);
+}
+
+TEST(World, Bullet)
+{
+	World world;
+	BodyRef bodyRefs[2];
+
+	const auto wallRef = world.CreateBody();
+
+	world.GetBody(wallRef).SetBodyType(BodyType::Static);
+	world.GetCollider(world.CreateCollider(wallRef)).SetRectangle(RectangleF(Vec2F(4.9f, -2.f), Vec2F(5.1f, 2.f)));
+
+	for (auto& bodyRef : bodyRefs)
+	{
+		bodyRef = world.CreateBody();
+
+		world.GetBody(bodyRef).SetVelocity(Vec2F(100.f, 0.f));
+		world.GetCollider(world.CreateCollider(bodyRef)).SetCircle(CircleF(Vec2F::Zero(), 0.25f));
+	}
+
+	world.GetBody(bodyRefs[1]).SetBullet(true);
+
+	// The move of a step is much larger than the wall
+	world.Update(0.1f);
+
+	const auto& body = world.GetBody(bodyRefs[0]);
+	const auto& bullet = world.GetBody(bodyRefs[1]);
+
+	EXPECT_NEAR(body.Position().X, 10.f, 1e-4f);
+	EXPECT_NEAR(bullet.Position().X, 4.65f, 1e-3f);
+	EXPECT_LE(bullet.Velocity().X, 0.f);
+
+	world.Update(0.1f);
+
+	EXPECT_LT(bullet.Position().X, 4.9f);
+}
+
+TEST(World, NarrowPhaseBatches)
+{
+	World world;
+	CountingContactListener contactListener;
+	std::vector<ColliderRef> colliderRefs;
+	std::uint32_t seed = 1234;
+	const auto random = [&seed](float min, float max) {
+		seed = seed * 1664525u + 1013904223u;
+		return min + (max - min) * static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+	};
+
+	world.SetContactListener(&contactListener);
+
+	// Enough circles and rectangles for full batches and a partial one, close enough for some of them to overlap
+	for (std::size_t i = 0; i < 300; i++)
+	{
+		const auto bodyRef = world.CreateBody();
+		const auto colliderRef = world.CreateCollider(bodyRef);
+		auto& collider = world.GetCollider(colliderRef);
+
+		world.GetBody(bodyRef).SetBodyType(BodyType::Kinematic);
+		world.GetBody(bodyRef).SetPosition(Vec2F(random(0.f, 20.f), random(0.f, 20.f)));
+
+		if (i % 3 == 0)
+		{
+			collider.SetRectangle(RectangleF(Vec2F(-random(0.1f, 1.f), -random(0.1f, 1.f)), Vec2F(random(0.1f, 1.f), random(0.1f, 1.f))));
+		}
+		else
+		{
+			collider.SetCircle(CircleF(Vec2F::Zero(), random(0.1f, 1.f)));
+		}
+
+		collider.SetIsTrigger(true);
+		colliderRefs.push_back(colliderRef);
+	}
+
+	world.Update(1.f / 60.f);
+
+	// The batches keep the same pairs as the shapes checked one at a time
+	auto expectedCount = 0;
+
+	for (std::size_t i = 0; i < colliderRefs.size(); i++)
+	{
+		for (std::size_t j = i + 1; j < colliderRefs.size(); j++)
+		{
+			const auto& colliderA = world.GetCollider(colliderRefs[i]);
+			const auto& colliderB = world.GetCollider(colliderRefs[j]);
+			const auto circleA = colliderA.GetShapeType() == ShapeType::Circle;
+			const auto circleB = colliderB.GetShapeType() == ShapeType::Circle;
+
+			if ((circleA && circleB && Intersect(colliderA.GetWorldCircle(), colliderB.GetWorldCircle())) ||
+				(circleA && !circleB && Intersect(colliderA.GetWorldCircle(), colliderB.GetWorldRectangle())) ||
+				(!circleA && circleB && Intersect(colliderA.GetWorldRectangle(), colliderB.GetWorldCircle())) ||
+				(!circleA && !circleB && Intersect(colliderA.GetWorldRectangle(), colliderB.GetWorldRectangle())))
+			{
+				expectedCount++;
+			}
+		}
+	}
+
+	EXPECT_GT(expectedCount, 0);
+	EXPECT_EQ(contactListener.EnterCount, expectedCount);
+}
+
+TEST(World, ContactEvents)
+{
+	World world;
+	CountingContactListener contactListener;
+
+	world.SetContactListener(&contactListener);
+	world.SetContactEventTypes(ContactEventTypes{true, false, true});
+
+	const auto bodyRefA = world.CreateBody();
+	const auto bodyRefB = world.CreateBody();
+	const auto colliderRefA = world.CreateCollider(bodyRefA);
+	const auto colliderRefB = world.CreateCollider(bodyRefB);
+
+	world.GetCollider(colliderRefA).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+	world.GetCollider(colliderRefA).SetIsTrigger(true);
+	world.GetCollider(colliderRefB).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+	world.GetBody(bodyRefB).SetPosition(Vec2F(0.5f, 0.f));
+
+	world.Update(1.f / 60.f);
+
+	const auto& events = world.GetContactEvents();
+
+	ASSERT_EQ(events.TriggerEnters.size(), 1);
+	EXPECT_EQ(events.TriggerEnters[0].A, colliderRefA);
+	EXPECT_EQ(events.TriggerEnters[0].B, colliderRefB);
+	EXPECT_TRUE(events.CollisionEnters.empty());
+	EXPECT_EQ(contactListener.EnterCount, 1);
+
+	// The stay events are not written when they are not chosen, the listener still gets them
+	world.Update(1.f / 60.f);
+
+	EXPECT_TRUE(events.TriggerEnters.empty());
+	EXPECT_TRUE(events.TriggerStays.empty());
+	EXPECT_EQ(contactListener.StayCount, 1);
+
+	world.SetContactEventTypes(ContactEventTypes{true, true, true});
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(events.TriggerStays.size(), 1);
+
+	world.GetBody(bodyRefB).SetPosition(Vec2F(10.f, 0.f));
+	world.Update(1.f / 60.f);
+
+	EXPECT_TRUE(events.TriggerStays.empty());
+	ASSERT_EQ(events.TriggerExits.size(), 1);
+	EXPECT_EQ(events.TriggerExits[0].A, colliderRefA);
+	EXPECT_EQ(contactListener.ExitCount, 1);
+
+	// Advance keeps the events of all its fixed updates
+	world.SetFixedTimeStep(0.1f, 3);
+	world.GetBody(bodyRefB).SetPosition(Vec2F(0.5f, 0.f));
+
+	EXPECT_EQ(world.Advance(0.25f), 2);
+	EXPECT_EQ(events.TriggerEnters.size(), 1);
+	EXPECT_EQ(events.TriggerStays.size(), 1);
+}
+
+TEST(World, Clear)
+{
+	World world;
+	CountingContactListener contactListener;
+	BodyRef bodyRefs[2];
+	ColliderRef colliderRefs[2];
+
+	world.SetContactListener(&contactListener);
+	world.SetGravity(Vec2F(0.f, -10.f));
+
+	for (std::size_t i = 0; i < 2; i++)
+	{
+		bodyRefs[i] = world.CreateBody();
+		colliderRefs[i] = world.CreateCollider(bodyRefs[i]);
+		world.GetCollider(colliderRefs[i]).SetCircle(CircleF(Vec2F::Zero(), 1.f));
+		world.GetCollider(colliderRefs[i]).SetIsTrigger(true);
+	}
+
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.EnterCount, 1);
+
+	world.Clear();
+
+	EXPECT_THROW(world.GetBody(bodyRefs[0]), InvalidBodyRefException);
+	EXPECT_THROW(world.GetCollider(colliderRefs[1]), InvalidColliderRefException);
+
+	// The destroyed pair does not exit and the indices are used again from the first one
+	world.Update(1.f / 60.f);
+
+	EXPECT_EQ(contactListener.ExitCount, 0);
+
+	const auto bodyRef = world.CreateBody();
+	const auto colliderRef = world.CreateCollider(bodyRef);
+
+	EXPECT_EQ(bodyRef.Index, 0);
+	EXPECT_EQ(colliderRef.Index, 0);
+}
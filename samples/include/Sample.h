@@ -22,7 +22,7 @@ public:
 	[[nodiscard]] constexpr std::string GetDescription() const noexcept { return _description; }
 
     /**
-     * @brief Update the sample.
+     * @brief Update the sample, the world runs the fixed updates that fit in the time.
      * @param deltaTime The time since the last update.
      */
     void Update(float deltaTime) noexcept;
@@ -144,14 +144,14 @@ void CollisionSample::onRender() noexcept
 {
     for (auto& object : _objects)
     {
-        const auto& body = _world.GetBody(object.BodyRef);
+        const auto position = _world.GetInterpolatedPosition(object.BodyRef);
         const auto& collider = _world.GetCollider(object.ColliderRef);
 
         switch(collider.GetShapeType())
         {
             case Math::ShapeType::Circle:
             {
-                const auto circle = collider.GetCircle() + body.Position();
+                const auto circle = collider.GetCircle() + position;
 
                 Display::Draw(circle, object.ObjectColor);
 
@@ -169,7 +169,7 @@ void CollisionSample::onRender() noexcept
 
             case Math::ShapeType::Rectangle:
             {
-                const auto rect = collider.GetRectangle() + body.Position();
+                const auto rect = collider.GetRectangle() + position;
 
                 Display::Draw(rect, object.ObjectColor);
 
@@ -122,14 +122,14 @@ void GravitySample::onRender() noexcept
 {
     for (auto& object : _objects)
     {
-        const auto& body = _world.GetBody(object.BodyRef);
+        const auto position = _world.GetInterpolatedPosition(object.BodyRef);
         const auto& collider = _world.GetCollider(object.ColliderRef);
 
         switch(collider.GetShapeType())
         {
             case Math::ShapeType::Circle:
             {
-                const auto circle = collider.GetCircle() + body.Position();
+                const auto circle = collider.GetCircle() + position;
 
                 Display::Draw(circle, _shapeColor);
             }
@@ -137,7 +137,7 @@ void GravitySample::onRender() noexcept
 
             case Math::ShapeType::Rectangle:
             {
-                const auto rect = collider.GetRectangle() + body.Position();
+                const auto rect = collider.GetRectangle() + position;
 
                 Display::Draw(rect, _shapeColor);
             }
@@ -148,10 +148,9 @@ void GravitySample::onRender() noexcept
         }
     }
 
-    const auto& groundBody = _world.GetBody(_ground.BodyRef);
     const auto& groundCollider = _world.GetCollider(_ground.ColliderRef);
 
-    Display::Draw(groundCollider.GetRectangle() + groundBody.Position(), _groundColor);
+    Display::Draw(groundCollider.GetRectangle() + _world.GetInterpolatedPosition(_ground.BodyRef), _groundColor);
 
     const Math::Vec2F mousePosition = static_cast<Math::Vec2F>(Input::GetMousePosition());
 
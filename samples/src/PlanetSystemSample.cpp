@@ -179,16 +179,12 @@ void PlanetSystemSample::onRender() noexcept
 {
 	for (const auto& planet : _planets)
     {
-        auto& body = _world.GetBody(planet.BodyRef);
-
-	    Display::Draw(Math::CircleF{{body.Position().X, body.Position().Y}, planet.Radius}, planet.PlanetColor);
+	    Display::Draw(Math::CircleF{_world.GetInterpolatedPosition(planet.BodyRef), planet.Radius}, planet.PlanetColor);
     }
 
     for (auto& sun : _suns)
     {
-        auto& sunBody = _world.GetBody(sun);
-
-	    Display::Draw(Math::CircleF{{sunBody.Position().X, sunBody.Position().Y}, _sunRadius}, _sunColor);
+	    Display::Draw(Math::CircleF{_world.GetInterpolatedPosition(sun), _sunRadius}, _sunColor);
     }
 }
 
@@ -21,7 +21,7 @@ void Sample::Update(float deltaTime) noexcept
 	ZoneNamedN(sampleUpdate, "Sample::Update", true);
 #endif
 
-    _world.Update(deltaTime);
+    _world.Advance(deltaTime);
 
 	if (!Display::IsMouseOnAnImGuiWindow())
 	{
@@ -45,7 +45,9 @@ void Sample::Init() noexcept
 void Sample::Deinit() noexcept
 {
     onDeinit();
-    _world = Physics::World();
+    _world.Clear();
+    _world.SetContactListener(nullptr);
+    _world.SetGravity(Math::Vec2F::Zero());
 }
 
 void Sample::DrawImGui() noexcept
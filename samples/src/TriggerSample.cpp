@@ -179,14 +179,14 @@ void TriggerSample::onRender() noexcept
 {
     for (auto& object : _objects)
     {
-        const auto& body = _world.GetBody(object.BodyRef);
+        const auto position = _world.GetInterpolatedPosition(object.BodyRef);
         const auto& collider = _world.GetCollider(object.ColliderRef);
 
         switch(collider.GetShapeType())
         {
             case Math::ShapeType::Circle:
             {
-                const auto circle = collider.GetCircle() + body.Position();
+                const auto circle = collider.GetCircle() + position;
 
                 if (object.TriggerEnterTimer > 0.f)
                 {
@@ -204,7 +204,7 @@ void TriggerSample::onRender() noexcept
 
             case Math::ShapeType::Rectangle:
             {
-                const auto rect = collider.GetRectangle() + body.Position();
+                const auto rect = collider.GetRectangle() + position;
 
                 if (object.TriggerEnterTimer > 0.f)
                 {
@@ -222,7 +222,7 @@ void TriggerSample::onRender() noexcept
 
             case Math::ShapeType::Polygon:
             {
-                auto poly = collider.GetPolygon() + body.Position();
+                auto poly = collider.GetPolygon() + position;
 
                 if (object.TriggerEnterTimer > 0.f)
                 {
@@ -246,10 +246,9 @@ void TriggerSample::onRender() noexcept
     }
 
 	// Draw the mouse object
-	const auto& mouseBody = _world.GetBody(_mouseObject.BodyRef);
 	const auto& mouseCollider = _world.GetCollider(_mouseObject.ColliderRef);
 
-	Display::Draw(mouseCollider.GetCircle() + mouseBody.Position(), Color::White());
+	Display::Draw(mouseCollider.GetCircle() + _world.GetInterpolatedPosition(_mouseObject.BodyRef), Color::White());
 	if (_showBoxes) Display::DrawBorder(mouseCollider.GetBounds(), Color::White(), 2.f);
 
     // Clear object color